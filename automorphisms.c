@@ -0,0 +1,384 @@
+/**
+ * automorphisms.c
+ *
+ * A description of the methods can be found in the header file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "bitset.h"
+#include "automorphisms.h"
+
+//  The automorphisms found so far, which together generate the automorphism
+//  group once the search has finished. The vertices which get a new colour
+//  along the leftmost branch of the search tree form a base. Then orbits
+//  [level] is a union-find structure of the orbits of the automorphisms
+//  found so far which fix the first level base vertices. The root of every
+//  orbit is its smallest vertex.
+struct automorphismSearch {
+    bitset *adjacencyList;
+    int numberOfVertices;
+    int orbits[MAXVERTICES][MAXVERTICES];
+    int (*generators)[MAXVERTICES];
+    int numberOfGenerators;
+    int maxGenerators;
+};
+
+static int findRoot(int orbits[], int vertex) {
+    while(orbits[vertex] != vertex) {
+        orbits[vertex] = orbits[orbits[vertex]];
+        vertex = orbits[vertex];
+    }
+    return vertex;
+}
+
+static void uniteOrbits(int orbits[], int v, int w) {
+    v = findRoot(orbits, v);
+    w = findRoot(orbits, w);
+    if(v < w) {
+        orbits[w] = v;
+    }
+    else {
+        orbits[v] = w;
+    }
+}
+
+//  Refines the colouring until every two vertices of the same colour have
+//  the same number of neighbours of every colour and returns the number of
+//  colours. The new colours only depend on the old colours and the
+//  neighbour counts, so that isomorphic coloured graphs are refined into
+//  isomorphic coloured graphs.
+static int refineColouring(bitset adjacencyList[], int numberOfVertices, int
+colours[], int numberOfColours) {
+    while(true) {
+        bitset cells[numberOfColours];
+        for(int colour = 0; colour < numberOfColours; colour++) {
+            cells[colour] = EMPTY;
+        }
+        for(int v = 0; v < numberOfVertices; v++) {
+            add(cells[colours[v]], v);
+        }
+
+        //  The signature of a vertex is its colour followed by its number of
+        //  neighbours of every colour.
+        int signatures[numberOfVertices][numberOfColours + 1];
+        for(int v = 0; v < numberOfVertices; v++) {
+            signatures[v][0] = colours[v];
+            for(int colour = 0; colour < numberOfColours; colour++) {
+                signatures[v][colour + 1] =
+                 size(intersection(adjacencyList[v], cells[colour]));
+            }
+        }
+        size_t signatureSize = sizeof(signatures[0]);
+
+        //  Sort the vertices by their signature.
+        int order[numberOfVertices];
+        for(int i = 0; i < numberOfVertices; i++) {
+            int v = i;
+            int j = i;
+            while(j > 0 &&
+             memcmp(signatures[order[j - 1]], signatures[v], signatureSize) >
+             0) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = v;
+        }
+
+        //  Vertices get the rank of their signature as new colour.
+        int newNumberOfColours = 0;
+        for(int i = 0; i < numberOfVertices; i++) {
+            if(i == 0 || memcmp(signatures[order[i - 1]],
+             signatures[order[i]], signatureSize) != 0) {
+                newNumberOfColours++;
+            }
+            colours[order[i]] = newNumberOfColours - 1;
+        }
+        if(newNumberOfColours == numberOfColours) {
+            return numberOfColours;
+        }
+        numberOfColours = newNumberOfColours;
+    }
+}
+
+//  Gives vertex a new colour and refines the colouring. Returns the new
+//  number of colours.
+static int individualise(bitset adjacencyList[], int numberOfVertices, int
+colours[], int numberOfColours, int vertex) {
+    colours[vertex] = numberOfColours;
+    return refineColouring(adjacencyList, numberOfVertices, colours,
+     numberOfColours + 1);
+}
+
+//  Returns the smallest colour which more than one vertex has, or -1 if
+//  all colours are distinct.
+static int firstNonSingletonColour(int colours[], int numberOfVertices, int
+numberOfColours) {
+    if(numberOfColours == numberOfVertices) {
+        return -1;
+    }
+    int sizes[numberOfColours];
+    memset(sizes, 0, sizeof(sizes));
+    for(int v = 0; v < numberOfVertices; v++) {
+        sizes[colours[v]]++;
+    }
+    for(int colour = 0; colour < numberOfColours; colour++) {
+        if(sizes[colour] > 1) {
+            return colour;
+        }
+    }
+    return -1;
+}
+
+static bitset verticesOfColour(int colours[], int numberOfVertices, int
+colour) {
+    bitset vertices = EMPTY;
+    for(int v = 0; v < numberOfVertices; v++) {
+        if(colours[v] == colour) {
+            add(vertices, v);
+        }
+    }
+    return vertices;
+}
+
+static bool isAutomorphism(bitset adjacencyList[], int numberOfVertices, int
+automorphism[]) {
+    for(int v = 0; v < numberOfVertices; v++) {
+        bitset image = EMPTY;
+        forEach(neighbour, adjacencyList[v]) {
+            add(image, automorphism[neighbour]);
+        }
+        if(!equals(image, adjacencyList[automorphism[v]])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Searches an automorphism which maps every vertex of the first colouring
+//  onto a vertex with the same colour in the second colouring. Both
+//  colourings need to be refined.
+static bool findAutomorphism(struct automorphismSearch *search, int
+colours[], int numberOfColours, int targetColours[], int
+numberOfTargetColours, int automorphism[]) {
+    bitset *adjacencyList = search->adjacencyList;
+    int numberOfVertices = search->numberOfVertices;
+    if(numberOfColours != numberOfTargetColours) {
+        return false;
+    }
+    int sizes[numberOfColours];
+    memset(sizes, 0, sizeof(sizes));
+    for(int v = 0; v < numberOfVertices; v++) {
+        sizes[colours[v]]++;
+        sizes[targetColours[v]]--;
+    }
+    for(int colour = 0; colour < numberOfColours; colour++) {
+        if(sizes[colour] != 0) {
+            return false;
+        }
+    }
+
+    int colour = firstNonSingletonColour(colours, numberOfVertices,
+     numberOfColours);
+    if(colour == -1) {
+        int vertexOfColour[numberOfVertices];
+        for(int v = 0; v < numberOfVertices; v++) {
+            vertexOfColour[targetColours[v]] = v;
+        }
+        for(int v = 0; v < numberOfVertices; v++) {
+            automorphism[v] = vertexOfColour[colours[v]];
+        }
+        return isAutomorphism(adjacencyList, numberOfVertices, automorphism);
+    }
+
+    //  Give the first vertex of the cell a new colour and try all vertices
+    //  of the corresponding cell of the target as its image.
+    int individualised[numberOfVertices];
+    memcpy(individualised, colours, sizeof(individualised));
+    int numberOfIndividualisedColours = individualise(adjacencyList,
+     numberOfVertices, individualised, numberOfColours,
+     next(verticesOfColour(colours, numberOfVertices, colour), -1));
+    forEach(image, verticesOfColour(targetColours, numberOfVertices, colour)) {
+        int individualisedTarget[numberOfVertices];
+        memcpy(individualisedTarget, targetColours,
+         sizeof(individualisedTarget));
+        int numberOfIndividualisedTargetColours = individualise(adjacencyList,
+         numberOfVertices, individualisedTarget, numberOfTargetColours, image);
+        if(findAutomorphism(search, individualised,
+         numberOfIndividualisedColours, individualisedTarget,
+         numberOfIndividualisedTargetColours, automorphism)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//  Stores the automorphism and merges the orbits it connects for all levels
+//  up to level, since it fixes the base vertices of these levels.
+static void addGenerator(struct automorphismSearch *search, int
+automorphism[], int level) {
+    if(search->numberOfGenerators == search->maxGenerators) {
+        search->maxGenerators = 2 * search->maxGenerators + 1;
+        search->generators = realloc(search->generators,
+         search->maxGenerators * sizeof(search->generators[0]));
+        if(search->generators == NULL) {
+            fprintf(stderr, "Error: out of memory.\n");
+            exit(1);
+        }
+    }
+    memcpy(search->generators[search->numberOfGenerators++], automorphism,
+     search->numberOfVertices * sizeof(int));
+    for(int l = 0; l <= level; l++) {
+        for(int v = 0; v < search->numberOfVertices; v++) {
+            uniteOrbits(search->orbits[l], v, automorphism[v]);
+        }
+    }
+}
+
+//  Finds generators of the automorphisms which respect the colouring. First
+//  those which also fix the first vertex of the first non-singleton cell are
+//  found, then for every other vertex of this cell which is not yet known to
+//  lie in the orbit of the first vertex, an automorphism mapping the first
+//  vertex onto it is searched.
+static void findGenerators(struct automorphismSearch *search, int colours[],
+int numberOfColours, int level) {
+    int numberOfVertices = search->numberOfVertices;
+    int *orbits = search->orbits[level];
+    for(int v = 0; v < numberOfVertices; v++) {
+        orbits[v] = v;
+    }
+    int colour = firstNonSingletonColour(colours, numberOfVertices,
+     numberOfColours);
+    if(colour == -1) {
+        return;
+    }
+    bitset cell = verticesOfColour(colours, numberOfVertices, colour);
+    int baseVertex = next(cell, -1);
+    int baseColours[numberOfVertices];
+    memcpy(baseColours, colours, sizeof(baseColours));
+    int numberOfBaseColours = individualise(search->adjacencyList,
+     numberOfVertices, baseColours, numberOfColours, baseVertex);
+    findGenerators(search, baseColours, numberOfBaseColours, level + 1);
+
+    forEachAfterIndex(vertex, cell, baseVertex) {
+        if(findRoot(orbits, vertex) == findRoot(orbits, baseVertex)) {
+            continue;
+        }
+        int vertexColours[numberOfVertices];
+        memcpy(vertexColours, colours, sizeof(vertexColours));
+        int numberOfVertexColours = individualise(search->adjacencyList,
+         numberOfVertices, vertexColours, numberOfColours, vertex);
+        int automorphism[numberOfVertices];
+        if(findAutomorphism(search, baseColours, numberOfBaseColours,
+         vertexColours, numberOfVertexColours, automorphism)) {
+            addGenerator(search, automorphism, level);
+        }
+    }
+}
+
+//  Returns a search containing generators of the automorphisms fixing the
+//  given vertices, which should be freed with freeAutomorphismSearch.
+static struct automorphismSearch *findAutomorphisms(bitset adjacencyList[],
+int numberOfVertices, int fixedVertices[], int numberOfFixedVertices) {
+    struct automorphismSearch *search = malloc(sizeof(*search));
+    if(search == NULL) {
+        fprintf(stderr, "Error: out of memory.\n");
+        exit(1);
+    }
+    search->adjacencyList = adjacencyList;
+    search->numberOfVertices = numberOfVertices;
+    search->generators = NULL;
+    search->numberOfGenerators = 0;
+    search->maxGenerators = 0;
+    if(numberOfVertices == 0) {
+        return search;
+    }
+
+    //  Every fixed vertex gets its own colour.
+    int colours[numberOfVertices];
+    for(int v = 0; v < numberOfVertices; v++) {
+        colours[v] = 0;
+    }
+    for(int i = 0; i < numberOfFixedVertices; i++) {
+        colours[fixedVertices[i]] = i + 1;
+    }
+    int numberOfColours = refineColouring(adjacencyList, numberOfVertices,
+     colours, numberOfFixedVertices + 1);
+    findGenerators(search, colours, numberOfColours, 0);
+    return search;
+}
+
+static void freeAutomorphismSearch(struct automorphismSearch *search) {
+    free(search->generators);
+    free(search);
+}
+
+bitset vertexOrbitRepresentatives(bitset adjacencyList[], int
+numberOfVertices, int fixedVertices[], int numberOfFixedVertices) {
+    struct automorphismSearch *search = findAutomorphisms(adjacencyList,
+     numberOfVertices, fixedVertices, numberOfFixedVertices);
+    bitset representatives = EMPTY;
+    for(int v = 0; v < numberOfVertices; v++) {
+        if(findRoot(search->orbits[0], v) == v) {
+            add(representatives, v);
+        }
+    }
+    freeAutomorphismSearch(search);
+    return representatives;
+}
+
+void edgeOrbitRepresentatives(bitset adjacencyList[], int numberOfVertices,
+int fixedVertices[], int numberOfFixedVertices, bitset representatives[]) {
+    struct automorphismSearch *search = findAutomorphisms(adjacencyList,
+     numberOfVertices, fixedVertices, numberOfFixedVertices);
+
+    //  reached[v] contains w if the edge vw lies in the orbit of an earlier
+    //  representative.
+    bitset reached[numberOfVertices];
+    int numberOfEdges = 0;
+    for(int v = 0; v < numberOfVertices; v++) {
+        reached[v] = EMPTY;
+        representatives[v] = EMPTY;
+        numberOfEdges += size(adjacencyList[v]);
+    }
+    int (*queue)[2] = malloc((numberOfEdges / 2 + 1) * sizeof(*queue));
+    if(queue == NULL) {
+        fprintf(stderr, "Error: out of memory.\n");
+        exit(1);
+    }
+    for(int v = 0; v < numberOfVertices; v++) {
+        forEachAfterIndex(w, adjacencyList[v], v) {
+            if(contains(reached[v], w)) {
+                continue;
+            }
+            add(representatives[v], w);
+
+            //  Mark the orbit of vw by applying the generators until no new
+            //  edges are found.
+            add(reached[v], w);
+            add(reached[w], v);
+            queue[0][0] = v;
+            queue[0][1] = w;
+            int queueEnd = 1;
+            for(int i = 0; i < queueEnd; i++) {
+                for(int g = 0; g < search->numberOfGenerators; g++) {
+                    int a = search->generators[g][queue[i][0]];
+                    int b = search->generators[g][queue[i][1]];
+                    if(contains(reached[a], b)) {
+                        continue;
+                    }
+                    add(reached[a], b);
+                    add(reached[b], a);
+                    queue[queueEnd][0] = a;
+                    queue[queueEnd][1] = b;
+                    queueEnd++;
+                }
+            }
+        }
+    }
+    free(queue);
+    freeAutomorphismSearch(search);
+}
@@ -0,0 +1,53 @@
+/**
+ *  This header file contains functions which compute the orbits of the
+ *  automorphism group of a graph on its vertices and edges. Subgraphs
+ *  obtained by deleting vertices or edges of the same orbit are isomorphic,
+ *  so only one of them needs to be checked.
+ *
+ *  The automorphisms are found by partition refinement and backtracking. A
+ *  colouring of the vertices is refined until all vertices of the same
+ *  colour have the same number of neighbours of every colour. If this does
+ *  not make all colours distinct, a vertex is given a new colour and the
+ *  colouring is refined again.
+ * */
+
+#ifndef AUTOMORPHISMS
+#define AUTOMORPHISMS
+
+#include "bitset.h"
+
+/**
+ *  Returns a bitset containing the smallest vertex of every orbit of the
+ *  automorphisms of the graph which fix the given vertices.
+ *
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the graph.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  fixedVertices   The vertices which every automorphism should map
+ *   onto themselves.
+ *  @param  numberOfFixedVertices   The number of vertices in fixedVertices.
+ *
+ *  @return A bitset containing one vertex of every orbit.
+ * */
+bitset vertexOrbitRepresentatives(bitset adjacencyList[], int
+numberOfVertices, int fixedVertices[], int numberOfFixedVertices);
+
+/**
+ *  Computes one edge of every orbit of the automorphisms of the graph which
+ *  fix the given vertices, namely the one vw with v < w for which v and then
+ *  w is smallest.
+ *
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the graph.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  fixedVertices   The vertices which every automorphism should map
+ *   onto themselves.
+ *  @param  numberOfFixedVertices   The number of vertices in fixedVertices.
+ *  @param  representatives An array of numberOfVertices bitsets. Afterwards
+ *   representatives[v] contains w if v < w and vw is the chosen edge of its
+ *   orbit.
+ * */
+void edgeOrbitRepresentatives(bitset adjacencyList[], int numberOfVertices,
+int fixedVertices[], int numberOfFixedVertices, bitset representatives[]);
+
+#endif
@@ -6,7 +6,7 @@
  */
 
 #define USAGE \
-"Usage: `./checkCell [-1|2] [-psSv] [-o#,#,#,#] [-h]`"
+"Usage: `./checkCell [-1|2] [-psSv] [-o#,#,#,#] [-O] [--progress=#] [--meet-in-the-middle=#] [-h]`"
 
 #define HELPTEXT \
 "Filter graphs that satisfy the conditions for being a suitable cell, a\n\
@@ -31,16 +31,32 @@ instances of `-o` are given (the lastmost instance will be chosen).\n\
             use with -1\n\
     -h, --help\n\
             print out help message\n\
+        --meet-in-the-middle=#\n\
+            look for hamiltonian paths between two given vertices by joining\n\
+            the paths from both ends over half of the vertices, which are\n\
+            kept in a table of at most # MiB; if a larger table is needed\n\
+            the paths are searched for as before; sends the number of such\n\
+            queries to stderr; has no effect if -v is present\n\
     -o, --outer-vertices\n\
             will only do the checks for the specified outer vertices;\n\
             use -o#,#,#,# where # represents an outer vertex; these need to\n\
             be distinct and in the graph; suitability of all permutations of\n\
             these vertices will be checked; if combining with -s the order\n\
             does matter\n\
+    -O, --orbits\n\
+            in the K1- or K2-cell check only look at one vertex or edge of\n\
+            every orbit of the automorphisms fixing the outer vertices; sends\n\
+            the number of skipped subgraphs to stderr; has no effect if -p or\n\
+            -v is present\n\
     -p, --paths\n\
             print the paths necessary to show that a suitable cell is K1 or\n\
             K2; if it is not all paths will be printed until the point of\n\
             failure; best combined with -v\n\
+        --progress=#\n\
+            every # seconds, send the number of read lines, checked graphs\n\
+            per second, search nodes per second and graphs per category to\n\
+            stderr; if stdin is a file, also how much of it was read and the\n\
+            estimated remaining time\n\
     -s, --suitable\n\
             skip the suitability check and assume all input graphs contain a\n\
             suitable cell at the specified vertices; this option requires -o\n\
@@ -60,7 +76,12 @@ instances of `-o` are given (the lastmost instance will be chosen).\n\
 #include <time.h>
 #include "../bitset.h"
 #include "../hamiltonicityMethods.h"
+#include "../automorphisms.h"
 #include "../readGraph/readGraph6.h"
+#include "../progress.h"
+
+//	Identifiers of the options which only have a long version.
+enum {PROGRESS_OPTION = 256, MEET_IN_THE_MIDDLE_OPTION};
 
 bool isSuitable(bitset adjacencyList[], int numberOfVertices, int
 outerVertices[]);
@@ -88,6 +109,7 @@ int main(int argc, char ** argv) {
 	bool k2cellFlag = false;
 	bool pathFlag = false;
 	bool statisticsFlag = false;
+	double progressInterval = 0;
 	int opt;
 	while (1) {
     	int option_index = 0;
@@ -96,15 +118,19 @@ int main(int argc, char ** argv) {
     		{"k1cell", 					no_argument, NULL,	'1'},
         	{"k2cell", 					no_argument, NULL,	'2'},
             {"help",                    no_argument, NULL,  'h'},
+        	{"meet-in-the-middle", required_argument, NULL,
+        	 MEET_IN_THE_MIDDLE_OPTION},
         	{"outer-vertices", 	  required_argument, NULL, 	'o'},
+        	{"orbits", 					no_argument, NULL,	'O'},
         	{"paths", 					no_argument, NULL, 	'p'},
+        	{"progress", 		  required_argument, NULL, 	PROGRESS_OPTION},
         	{"suitable", 				no_argument, NULL,	's'},
         	{"statistics", 				no_argument, NULL,  'S'},
         	{"verbose", 				no_argument, NULL,  'v'},
         	{NULL,      				0, 			 NULL,    0}
     	};
 
-    	opt = getopt_long(argc, argv, "12ho:psSv", long_options, &option_index);
+    	opt = getopt_long(argc, argv, "12ho:OpsSv", long_options, &option_index);
     	if (opt == -1) break;
 		switch(opt) {
 			case '1':
@@ -138,6 +164,9 @@ int main(int argc, char ** argv) {
 				}
 				outerVerticesDefined = true;
         		break;
+			case 'O':
+				searchSettings.orbitReduction = true;
+				break;
         	case 'p':
 				pathFlag = true;
 				break;
@@ -150,6 +179,29 @@ int main(int argc, char ** argv) {
 			case 'v':
 				verboseFlag = true;
 				break;
+			case MEET_IN_THE_MIDDLE_OPTION:
+				if(sscanf(optarg, "%d",
+				 &searchSettings.meetInTheMiddleMemory) != 1 ||
+				 searchSettings.meetInTheMiddleMemory < 1) {
+					fprintf(stderr, "Error: Invalid number of MiB: %s\n",
+					 optarg);
+					fprintf(stderr, "%s\n", USAGE);
+					fprintf(stderr,
+					 "Use ./checkCell --help for more detailed instructions.\n");
+					return 1;
+				}
+				break;
+			case PROGRESS_OPTION:
+				if(sscanf(optarg, "%lf", &progressInterval) != 1 ||
+				 progressInterval <= 0) {
+					fprintf(stderr, "Error: Invalid number of seconds: %s\n",
+					 optarg);
+					fprintf(stderr, "%s\n", USAGE);
+					fprintf(stderr,
+					 "Use ./checkCell --help for more detailed instructions.\n");
+					return 1;
+				}
+				break;
 		}
 	}
 
@@ -189,11 +241,24 @@ int main(int argc, char ** argv) {
 
 	clock_t start = clock();
 
+	if(progressInterval) {
+		const char *categoryNames[] = {"suitable", k1cellFlag ? "K1-cells" :
+		 "K2-cells"};
+		startProgress(progressInterval, k1cellFlag || k2cellFlag ? 2 : 1,
+		 categoryNames);
+	}
 
 	//	Loop over graphs.
 	char * graphString = NULL;
 	size_t size;
-	while(getline(&graphString, &size, stdin) != -1) {
+	ssize_t length;
+	unsigned long long int lines = 0;
+	unsigned long long int bytes = 0;
+	while((length = getline(&graphString, &size, stdin)) != -1) {
+		unsigned long long int categoryCounts[] = {suitableCounter,
+		 k1cellFlag ? K1CellCounter : K2CellCounter};
+		reportCheckedGraphs(counter, categoryCounts);
+		reportInput(++lines, bytes += length);
 		if(verboseFlag) {
 			fprintf(stderr, "Looking at %s",graphString);
 		}
@@ -315,6 +380,7 @@ int main(int argc, char ** argv) {
 			fprintf(stderr, "  The graph is not a %s-cell.\n", k1cellFlag ? "K1" : "K2");
 		}
 	}
+	stopProgress();
 	clock_t end = clock();
 	double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
 
@@ -327,6 +393,17 @@ int main(int argc, char ** argv) {
 	if(k2cellFlag) {
 		fprintf(stderr, "%lld contain a K2-cell.\n", K2CellCounter);
 	}
+	if(searchSettings.meetInTheMiddleMemory) {
+		fprintf(stderr,
+		 "Meet-in-the-middle: %lld path queries, %lld of which needed a larger table.\n",
+		 atomic_load(&meetInTheMiddleStatistics.queries),
+		 atomic_load(&meetInTheMiddleStatistics.fallbacks));
+	}
+	if(searchSettings.orbitReduction) {
+		fprintf(stderr, "Orbits: skipped %lld of %lld subgraphs.\n",
+		 atomic_load(&orbitStatistics.skipped),
+		 atomic_load(&orbitStatistics.subgraphs));
+	}
 	if(statisticsFlag) {
 		fprintf(stderr,
 		 "Suitability property 1.1 and 1.2 failed %lld %% of the time and took %f %% of the time.\n",
@@ -350,6 +427,9 @@ int main(int argc, char ** argv) {
         fprintf(stderr, "Warning: %lld graphs could not be read.\n",
          skippedGraphs);
     }
+#ifdef PRUNE_STATISTICS
+	printPruneStatistics();
+#endif
 	return 0;
 }
 
@@ -360,6 +440,22 @@ excludedVertices, int a, int b, bool verboseFlag) {
      excludedVertices, a, b, false, verboseFlag);
 }
 
+//	Check whether one of the numberOfPairs pairs is good in the (sub)graph.
+//	All pairs are searched together, which stops at the first good one.
+bool containsGoodPair(bitset adjacencyList[], int numberOfVertices, bitset
+excludedVertices, int pairs[][2], int numberOfPairs) {
+    bitset requestedPairs[numberOfVertices];
+    bitset goodPairs[numberOfVertices];
+    for(int i = 0; i < numberOfVertices; i++) {
+        requestedPairs[i] = EMPTY;
+    }
+    for(int i = 0; i < numberOfPairs; i++) {
+        add(requestedPairs[pairs[i][0]], pairs[i][1]);
+    }
+    return findHamiltonianPathEnds(adjacencyList, numberOfVertices,
+     excludedVertices, requestedPairs, true, goodPairs);
+}
+
 //	Check whether there exists an ab-path and a cd-path whose vertex sets
 //	partition the vertices of the (sub)graph.
 bool isGoodPairOfPairs(bitset adjacencyList[], int numberOfVertices, int a,
@@ -509,16 +605,20 @@ bitset* possiblePermutations, int outerVertices[]) {
 //	with v any outer vertex.
 bool satisfiesProperty5(bitset adjacencyList[], int numberOfVertices, int
 outerVertices[]) {
+    int outerPairs[6][2];
+    int numberOfPairs = 0;
+    for(int j = 0; j < 4; j++) {
+        for (int k = j+1; k < 4; k++) {
+            outerPairs[numberOfPairs][0] = outerVertices[j];
+            outerPairs[numberOfPairs++][1] = outerVertices[k];
+        }
+    }
+
     //  Property 1.5(a) and 1.5(b):
     for(int v = 0; v < 4; v++) {
-        for(int j = 0; j < 4; j++) {
-            for (int k = j+1; k < 4; k++) {
-                if (isGoodPair(adjacencyList,numberOfVertices,
-                 singleton(outerVertices[v]), outerVertices[j],
-                 outerVertices[k], false)) {
-                    return false;
-                }
-            }
+        if (containsGoodPair(adjacencyList, numberOfVertices,
+         singleton(outerVertices[v]), outerPairs, numberOfPairs)) {
+            return false;
         }
     }
     return true;
@@ -755,13 +855,19 @@ numberOfVertices, int a, int b, int c, int d, bitset excludedVertices, bool
 verboseFlag, bool pathFlag){
 
     //1.2
-    if(isGoodPair(adjacencyList,numberOfVertices, excludedVertices, a, d,
-     pathFlag)) {
+    //  Without paths to print, it only matters whether some pair is good.
+    int pairs1_2[2][2] = {{a,d},{b,c}};
+    if(!pathFlag && containsGoodPair(adjacencyList, numberOfVertices,
+     excludedVertices, pairs1_2, 2)) {
+        return true;
+    }
+    if(pathFlag && isGoodPair(adjacencyList,numberOfVertices,
+     excludedVertices, a, d, pathFlag)) {
         if(pathFlag) fprintf(stderr,"\t1.2 (a,d)\n");
         return true;
     }
-    if(isGoodPair(adjacencyList,numberOfVertices,excludedVertices, b, c,
-     pathFlag)) {
+    if(pathFlag && isGoodPair(adjacencyList,numberOfVertices,
+     excludedVertices, b, c, pathFlag)) {
         if(pathFlag) fprintf(stderr,"\t1.2 (b,c)\n");
         return true;
     }
@@ -780,7 +886,15 @@ verboseFlag, bool pathFlag){
 
     //1.5(a)
     int array[4] = {a,b,c,d};
+    int pairs1_5[4][2] = {{a,b},{a,c},{b,d},{c,d}};
     for(int j = 0; j < 4; j++) {
+        if(!pathFlag) {
+            if(containsGoodPair(adjacencyList, numberOfVertices,
+             union(excludedVertices, singleton(array[j])), pairs1_5, 4)) {
+                return true;
+            }
+            continue;
+        }
         if(isGoodPair(adjacencyList, numberOfVertices, 
          union(excludedVertices, singleton(array[j])), a,b, pathFlag)) {
             if(pathFlag) fprintf(stderr,"\t1.5 (a,b), outer vertex: %d\n",
@@ -816,11 +930,23 @@ verboseFlag, bool pathFlag){
 bool isK1Cell(bitset adjacencyList[], int numberOfVertices, int outerVertices
 [], bool verboseFlag, bool pathFlag) {
 
-    for(int i = 0; i < numberOfVertices; i++) {
-        if (i == outerVertices[0] || i == outerVertices[1]  ||
-         i == outerVertices[2] || i == outerVertices[3]) {
-            continue;
-        }
+    bitset innerVertices = difference(complement(EMPTY, numberOfVertices),
+     union(union(singleton(outerVertices[0]), singleton(outerVertices[1])),
+     union(singleton(outerVertices[2]), singleton(outerVertices[3]))));
+
+    //  Automorphisms fixing the outer vertices map G - v onto an isomorphic
+    //  cell, so one vertex of every orbit suffices.
+    if(searchSettings.orbitReduction && !verboseFlag && !pathFlag) {
+        bitset representatives = intersection(innerVertices,
+         vertexOrbitRepresentatives(adjacencyList, numberOfVertices,
+         outerVertices, 4));
+        atomic_fetch_add(&orbitStatistics.subgraphs, size(innerVertices));
+        atomic_fetch_add(&orbitStatistics.skipped, size(innerVertices) -
+         size(representatives));
+        innerVertices = representatives;
+    }
+
+    forEach(i, innerVertices) {
         if(pathFlag) fprintf(stderr,"G - %d:\n",i);
         if(badPairBecomesGoodInSubgraph(adjacencyList,numberOfVertices,
          outerVertices[0],outerVertices[1],outerVertices[2],outerVertices[3],
@@ -842,17 +968,36 @@ bool isK1Cell(bitset adjacencyList[], int numberOfVertices, int outerVertices
 bool isK2Cell(bitset adjacencyList[], int numberOfVertices, int outerVertices
 [], bool verboseFlag, bool pathFlag) {
 
-    //2.1
+    //  innerEdges[i] contains the inner neighbours of i which come after i.
+    //  Like in isK1Cell, only one edge of every orbit needs to be checked.
+    bitset outer = union(union(singleton(outerVertices[0]),
+     singleton(outerVertices[1])), union(singleton(outerVertices[2]),
+     singleton(outerVertices[3])));
+    bitset innerEdges[numberOfVertices];
+    int numberOfInnerEdges = 0;
     for(int i = 0; i < numberOfVertices; i++) {
-		if (i == outerVertices[0] || i == outerVertices[1]  || 
-		 i == outerVertices[2] || i == outerVertices[3]) {
-			continue;
+        innerEdges[i] = contains(outer, i) ? EMPTY :
+         difference(difference(adjacencyList[i], complement(EMPTY, i + 1)),
+         outer);
+        numberOfInnerEdges += size(innerEdges[i]);
+    }
+    if(searchSettings.orbitReduction && !verboseFlag && !pathFlag) {
+        bitset representatives[numberOfVertices];
+        edgeOrbitRepresentatives(adjacencyList, numberOfVertices,
+         outerVertices, 4, representatives);
+        int numberOfRepresentatives = 0;
+        for(int i = 0; i < numberOfVertices; i++) {
+            innerEdges[i] = intersection(innerEdges[i], representatives[i]);
+            numberOfRepresentatives += size(innerEdges[i]);
         }
-        forEachAfterIndex(neighbour, adjacencyList[i], i) {
-            if (neighbour == outerVertices[0] || neighbour == outerVertices[1]
-             || neighbour == outerVertices[2] || neighbour == outerVertices[3]) {
-                continue;
-            }
+        atomic_fetch_add(&orbitStatistics.subgraphs, numberOfInnerEdges);
+        atomic_fetch_add(&orbitStatistics.skipped, numberOfInnerEdges -
+         numberOfRepresentatives);
+    }
+
+    //2.1
+    for(int i = 0; i < numberOfVertices; i++) {
+        forEach(neighbour, innerEdges[i]) {
             if(pathFlag) fprintf(stderr, "%d %d\n", i, neighbour);
             if(badPairBecomesGoodInSubgraph(adjacencyList,numberOfVertices,
              outerVertices[0],outerVertices[1],outerVertices[2],outerVertices[3],
@@ -6,7 +6,7 @@
  */
 
 #define USAGE \
-"Usage: `./findExtendableC5 [-a|-c#,#,#,#,#] [-pv] [-h]`"
+"Usage: `./findExtendableC5 [-a|-c#,#,#,#,#] [-pv] [--progress=#] [-h]`"
 
 #define HELPTEXT \
 "Filter graphs that contain an extendable 5-cycle.\n\
@@ -30,6 +30,11 @@ instances of `-c` are given (the lastmost instance will be chosen).\n\
         if a cycle is found it will be sent to stdout; with -a this will be the\n\
         last found, with -c this will be the specified cycle (if it is\n\
         extendable) and without these flags it will be the first found\n\
+    --progress=#\n\
+        every # seconds, send the number of read lines, checked graphs per\n\
+        second, search nodes per second and graphs per category to stderr;\n\
+        if stdin is a file, also how much of it was read and the estimated\n\
+        remaining time\n\
     -v, --verbose\n\
         verbose mode; for each checked extendable 5-cycle print out the paths\n\
         showing it is one\n"
@@ -43,6 +48,10 @@ instances of `-c` are given (the lastmost instance will be chosen).\n\
 #include "../bitset.h"
 #include "../hamiltonicityMethods.h"
 #include "../readGraph/readGraph6.h"
+#include "../progress.h"
+
+//	Identifiers of the options which only have a long version.
+enum {PROGRESS_OPTION = 256};
 
 //	Returns whether or not the graph contains an extendable 5-cycle. A
 //	5-cycles gets stored in C5. If verboseFlag is true the paths showing
@@ -66,6 +75,7 @@ int main(int argc, char ** argv) {
 	bool cycleFlag = false;
 	bool printCycleFlag = false;
 	bool allFlag = false;
+	double progressInterval = 0;
 	while (1) {
     	int option_index = 0;
     	static struct option long_options[] = 
@@ -74,6 +84,8 @@ int main(int argc, char ** argv) {
             {"cycle",                       required_argument, NULL, 'c'},
             {"help",                    no_argument, NULL,  'h'},
         	{"print", 						no_argument, NULL, 'p'},
+            {"progress",                    required_argument, NULL,
+             PROGRESS_OPTION},
             {"verbose",                     no_argument, NULL,  'v'},
         	{NULL,      					0, 			 NULL,    0}
     	};
@@ -119,6 +131,17 @@ int main(int argc, char ** argv) {
 			case 'v':
 				verboseFlag = true;
 				break;
+			case PROGRESS_OPTION:
+				if(sscanf(optarg, "%lf", &progressInterval) != 1 ||
+				 progressInterval <= 0) {
+					fprintf(stderr, "Error: Invalid number of seconds: %s\n",
+					 optarg);
+					fprintf(stderr, "%s\n", USAGE);
+					fprintf(stderr,
+					 "Use ./findExtendableC5 --help for more detailed instructions.\n");
+					return 1;
+				}
+				break;
       		case ':':
        			fprintf(stderr,"Error: Missing arg for %c\n", optopt);
                 fprintf(stderr, "%s\n", USAGE);
@@ -147,9 +170,19 @@ int main(int argc, char ** argv) {
 
 	clock_t start = clock();
 
+	if(progressInterval) {
+		const char *categoryNames[] = {"with an extendable 5-cycle"};
+		startProgress(progressInterval, 1, categoryNames);
+	}
+
 	char * graphString = NULL;
 		size_t size;
-		while(getline(&graphString, &size, stdin) != -1) {
+		ssize_t length;
+		unsigned long long int lines = 0;
+		unsigned long long int bytes = 0;
+		while((length = getline(&graphString, &size, stdin)) != -1) {
+			reportCheckedGraphs(counter, &containExtC5);
+			reportInput(++lines, bytes += length);
 			int nVertices = getNumberOfVertices(graphString);
 	        if(nVertices == -1 || nVertices > MAXVERTICES) {
 	            if(verboseFlag){
@@ -210,6 +243,7 @@ int main(int argc, char ** argv) {
 					 "  Does not contain an extendable 5-cycle.\n\n");
 
 		}
+	stopProgress();
 
 	clock_t end = clock();
 	double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
@@ -220,6 +254,9 @@ int main(int argc, char ** argv) {
          skippedGraphs);
     }
 
+#ifdef PRUNE_STATISTICS
+	printPruneStatistics();
+#endif
 	return 0;
 }
 
@@ -284,22 +321,23 @@ bool isExtendable(bitset adjacencyList[], int nVertices, int C5[]) {
 	for(int i = 0; i < 5; i++) { 
 
 		// Check if G - w'_i contains ham cycle without w'_i-2w'_i+2.
-		removeElement(adjacencyList[C5[(i+3)%5]], C5[(i+2)%5]);
-		removeElement(adjacencyList[C5[(i+2)%5]], C5[(i+3)%5]);
-		bool isHam = isHamiltonian(adjacencyList, nVertices, singleton(C5[i]),
-         false, false);
-		add(adjacencyList[C5[(i+3)%5]], C5[(i+2)%5]);
-		add(adjacencyList[C5[(i+2)%5]], C5[(i+3)%5]);
-		if(!isHam) {
+		struct searchConstraints constraints;
+		initialiseSearchConstraints(&constraints, singleton(C5[i]));
+		forbidEdge(&constraints, C5[(i+3)%5], C5[(i+2)%5]);
+		if(!isHamiltonianWithConstraints(adjacencyList, nVertices, &constraints,
+         false, false)) {
 			return false;
 		}
 
 		// Check if G - w''_i contains ham cycle with the path
         // w'_i-2w'_i-1w'_iw'_i+1w'_i+2.
-		bitset remainingVertices = complement(union(path, adjacencyList[C5[i]]),
-         nVertices);
-		if(!canBeHamiltonian(adjacencyList, remainingVertices, C5[(i+3)%5],
-         C5[(i+2)%5], nVertices -1 , 5)) {
+		int pathList[5] = {C5[(i+2)%5], C5[(i+1)%5], C5[i], C5[(i+4)%5],
+         C5[(i+3)%5]};
+		initialiseSearchConstraints(&constraints,
+         difference(adjacencyList[C5[i]], path));
+		requirePath(&constraints, pathList, 5);
+		if(!isHamiltonianWithConstraints(adjacencyList, nVertices, &constraints,
+         false, false)) {
 			return false;
 		}
 	}
@@ -313,26 +351,20 @@ void printPaths(bitset adjacencyList[], int nVertices, int C5[]) {
 	}
 	for(int i=0; i < 5; i++) {
 		fprintf(stderr, "G - %d: ", C5[i]);
-		removeElement(adjacencyList[C5[(i+3)%5]], C5[(i+2)%5]);
-		removeElement(adjacencyList[C5[(i+2)%5]], C5[(i+3)%5]);
-		isHamiltonian(adjacencyList, nVertices, singleton(C5[i]), false, true);
-		add(adjacencyList[C5[(i+3)%5]], C5[(i+2)%5]);
-		add(adjacencyList[C5[(i+2)%5]], C5[(i+3)%5]);
+		struct searchConstraints constraints;
+		initialiseSearchConstraints(&constraints, singleton(C5[i]));
+		forbidEdge(&constraints, C5[(i+3)%5], C5[(i+2)%5]);
+		isHamiltonianWithConstraints(adjacencyList, nVertices, &constraints,
+         false, true);
 
-		bitset remainingVertices = complement(union(path, adjacencyList[C5[i]]),
-         nVertices);
-		int pathList[nVertices - 1];
-		pathList[0] = C5[(i+2)%5];
-		pathList[1] = C5[(i+1)%5];
-		pathList[2] = C5[(i+0)%5];
-		pathList[3] = C5[(i+4)%5];
-		pathList[4] = C5[(i+3)%5];
-		int numberOfHamiltonianCycles = 0;
+		int pathList[5] = {C5[(i+2)%5], C5[(i+1)%5], C5[i], C5[(i+4)%5],
+         C5[(i+3)%5]};
 		forEach(neighbour, difference(adjacencyList[C5[i]],path)){
 			fprintf(stderr, "G - %d: ", neighbour);
-			canBeHamiltonianPrintCycle(adjacencyList, remainingVertices,
-             pathList ,C5[(i+3)%5], C5[(i+2)%5], nVertices - 1, 5,
-              &numberOfHamiltonianCycles,false, true);
+			initialiseSearchConstraints(&constraints, singleton(neighbour));
+			requirePath(&constraints, pathList, 5);
+			isHamiltonianWithConstraints(adjacencyList, nVertices, &constraints,
+             false, true);
 		}
 	}
 }
@@ -6,7 +6,7 @@
  */
 
 #define USAGE \
-"\nUsage: `./hamiltonicityChecker [-t] [-1|-2] [-n] [-c] [-v] [-v#] [-v#,#] [-a] [-h] [res/mod]`\n"
+"\nUsage: `./hamiltonicityChecker [-t] [-1|-2] [-n] [-c] [-v] [-v#] [-v#,#] [-a] [-h] [--threads=#] [--subgraph-threads=#] [--search-threads=#] [--forced-edges] [--bidirectional] [--connectivity-check=#] [--articulation-check] [--held-karp=#] [--transposition-table=#] [--posa=#] [--lift-cycles] [--skip-search] [--orbits] [--max-nodes=#] [--max-seconds=#] [--deferred=FILE] [--progress=#] [--timings] [--timings-json=FILE] [--slow-graphs=FILE] [--slow-graphs-count=#] [res/mod]`\n"
 
 #define HELPTEXT \
 "Filter graphs satisfying certain hamiltonicity requirements.\n\
@@ -29,15 +29,109 @@ The order in which the arguments appear does not matter.\n\
             counts all hamiltonian cycles of the graph; if -v is present these\n\
             cycles get printed; if -v together with an optional argument\n\
             is present, this is also done for the corresponding subgraph\n\
+        --articulation-check\n\
+            let the connectivity check also cut off paths for which a vertex\n\
+            separates some of the remaining vertices from both endpoints\n\
+        --bidirectional\n\
+            extend the path of the search at whichever end has the fewest\n\
+            neighbours left instead of always at the same end; paths with\n\
+            only one extension are not counted as nodes; has no effect if -v\n\
+            or -a is present\n\
     -c, --complement\n\
             reverses which graphs are filtered\n\
+        --connectivity-check=#\n\
+            cut off paths of which the remaining vertices are disconnected;\n\
+            this is checked at every path length which is a multiple of #;\n\
+            sends the number of checks and cut off paths to stderr\n\
+        --deferred=FILE\n\
+            append the graphs which exceed --max-nodes or --max-seconds to\n\
+            FILE instead of checking them further, so that they can be\n\
+            checked again later with more resources\n\
+        --forced-edges\n\
+            determine which edges of the cycle are forced at every step of\n\
+            the search; this prunes many paths in graphs of low degree\n\
     -h, --help\n\
             print help message\n\
+        --held-karp=#\n\
+            check graphs with at most # vertices (at most 26) with a dynamic\n\
+            programming algorithm instead of a search; it takes O(2^n n)\n\
+            time and 2^(n+1) bytes of memory per graph, which is often faster\n\
+            for proving small graphs and their subgraphs non-hamiltonian; has\n\
+            no effect if -v or -a is present\n\
+        --lift-cycles\n\
+            keep the hamiltonian cycles found in subgraphs of a graph and\n\
+            try to turn these into cycles of the next subgraphs before\n\
+            searching; sends the number of subgraphs settled this way to\n\
+            stderr; has no effect if -v or -a is present\n\
+        --max-nodes=#\n\
+            give up on a graph once the searches for it visited about #\n\
+            nodes; such a graph is not sent to stdout, but to the file of\n\
+            --deferred if present; sends the number of these graphs to stderr\n\
+        --max-seconds=#\n\
+            give up on a graph once it has been checked for # seconds (wall\n\
+            clock time); like --max-nodes\n\
     -n, --assume-non-hamiltonian\n\
             let all graphs pass the non-hamiltonicity check; does not check\n\
             whether the graphs are actually non-hamiltonian\n\
+        --orbits\n\
+            compute the automorphism group of every graph and only check one\n\
+            vertex-deleted (-1) or edge-deleted (-2) subgraph of every orbit;\n\
+            sends the number of skipped subgraphs to stderr; has no effect if\n\
+            -v is present\n\
+        --posa=#\n\
+            before searching for a hamiltonian cycle in a (sub)graph, try to\n\
+            find one with at most # steps of a randomised rotation-extension\n\
+            heuristic; sends the number of cycles it found to stderr; has no\n\
+            effect if -v or -a is present\n\
+        --progress=#\n\
+            every # seconds, send the number of read lines, checked graphs\n\
+            per second, search nodes per second and graphs per category to\n\
+            stderr; if stdin is a file, also how much of it was read and the\n\
+            estimated remaining time\n\
+        --search-threads=#\n\
+            divide the search for a single hamiltonian cycle or path over #\n\
+            threads; useful if single (sub)graphs take very long to check;\n\
+            has no effect if -v or -a is present\n\
+        --skip-search\n\
+            check the vertex-deleted (-1) or edge-deleted (-2) subgraphs of a\n\
+            graph together in one search for cycles which skip a vertex or\n\
+            an edge; only the subgraphs without some vertex of lowest degree\n\
+            are checked separately; has no effect if -t or -v is present and\n\
+            takes precedence over --subgraph-threads\n\
+        --slow-graphs=FILE\n\
+            write the graphs which took the most search nodes (or, if equal,\n\
+            wall-clock time) in the non-hamiltonicity check and in the K1 or\n\
+            K2 check to FILE, with their numbers of nodes, their times, their\n\
+            line numbers and the vertex-deleted or edge-deleted subgraph\n\
+            which took the most nodes; every line starts with the graph\n\
+        --slow-graphs-count=#\n\
+            the number of graphs which --slow-graphs keeps per check; the\n\
+            default is 10\n\
+        --subgraph-threads=#\n\
+            check the vertex-deleted (-1) or edge-deleted (-2) subgraphs of a\n\
+            graph on # threads; the remaining checks are cancelled as soon as\n\
+            one of these subgraphs fails; has no effect if -v is present\n\
+        --threads=#\n\
+            check the graphs on # worker threads; one thread reads stdin and\n\
+            the graphs which pass through the filter are still sent to stdout\n\
+            in the order in which they were read; cannot be used with -v or -a\n\
+        --timings\n\
+            send the wall-clock and CPU time spent on reading the graphs, on\n\
+            the non-hamiltonicity check and on the K1 or K2 check to stderr;\n\
+            the CPU time of a phase is that of the thread checking the graph,\n\
+            so it does not include the helper threads of --subgraph-threads\n\
+            and --search-threads\n\
+        --timings-json=FILE\n\
+            write the same times as --timings to FILE in JSON format\n\
     -t, --traceable\n\
-            check for hamiltonian paths instead of cycles\n\
+            check for hamiltonian paths instead of cycles; together with -1\n\
+            or -2 this filters hypotraceable or K2-hypotraceable graphs\n\
+        --transposition-table=#\n\
+            remember the paths which could not be extended to a hamiltonian\n\
+            cycle in a table of # MiB, so that these are not searched again\n\
+            when they are reached in another order; the table is shared by\n\
+            all subgraphs of a graph and all threads; sends the number of\n\
+            hits and misses to stderr\n\
     -v, --verbose\n\
             verbose mode; if -a is absent prints one hamiltonian cycle (if one\n\
             exists); if -a is present prints all hamiltonian cycles; if\n\
@@ -50,34 +144,70 @@ The order in which the arguments appear does not matter.\n\
 #include <stdbool.h>
 #include <getopt.h>
 #include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 #include "bitset.h"
 #include "hamiltonicityMethods.h"
 #include "readGraph/readGraph6.h"
+#include "progress.h"
+
+//  Identifiers of the options which only have a long version.
+enum {THREADS_OPTION = 256, SUBGRAPH_THREADS_OPTION,
+ SEARCH_THREADS_OPTION, FORCED_EDGES_OPTION, CONNECTIVITY_CHECK_OPTION,
+ ARTICULATION_CHECK_OPTION, HELD_KARP_OPTION, TRANSPOSITION_TABLE_OPTION,
+ POSA_OPTION, LIFT_CYCLES_OPTION, SKIP_SEARCH_OPTION, ORBITS_OPTION,
+ MAX_NODES_OPTION, MAX_SECONDS_OPTION, DEFERRED_OPTION, PROGRESS_OPTION,
+ TIMINGS_OPTION, TIMINGS_JSON_OPTION, SLOW_GRAPHS_OPTION,
+ SLOW_GRAPHS_COUNT_OPTION, BIDIRECTIONAL_OPTION};
 
 //  Skip hamiltonicity check if -n or --assume-non-hamiltonian was given.
+//  Graphs which are not 2-connected are non-hamiltonian. Unless cycles need to
+//  be printed or counted, these are not searched and settledByConnectivity is
+//  set.
 bool isNonHamOrAssumedNonHam(bitset adjacencyList[], int nVertices, bool
-verboseFlag, bool assumeNonHamFlag, bool allCyclesFlag) {
+verboseFlag, bool assumeNonHamFlag, bool allCyclesFlag, bool
+*settledByConnectivity) {
     if(assumeNonHamFlag) {
         return true;
     }
+    if(!verboseFlag && !allCyclesFlag &&
+     !isKConnected(adjacencyList, nVertices, EMPTY, 2)) {
+        *settledByConnectivity = true;
+        return true;
+    }
     return !isHamiltonian(adjacencyList,nVertices, EMPTY, allCyclesFlag,
      verboseFlag);
 } 
 
+//  Disconnected graphs are non-traceable.
 bool isNonTraceableOrAssumedNonTraceable(bitset adjacencyList[], int
-nVertices, bool verboseFlag, bool assumeNonHamFlag, bool allCyclesFlag) {
+nVertices, bool verboseFlag, bool assumeNonHamFlag, bool allCyclesFlag,
+bool *settledByConnectivity) {
     if(assumeNonHamFlag) {
         return true;
     }
+    if(!verboseFlag && !allCyclesFlag &&
+     !isKConnected(adjacencyList, nVertices, EMPTY, 1)) {
+        *settledByConnectivity = true;
+        return true;
+    }
     return !isTraceable(adjacencyList,nVertices, EMPTY, allCyclesFlag,
      verboseFlag);
 } 
 
 //  Determine whether the given graph should be written or not assuming it is
-//  non-hamiltonian.
+//  non-hamiltonian. K1-hamiltonian graphs and K2-hamiltonian graphs (which
+//  have minimum degree 3) are 3-connected, so other graphs do not need to be
+//  searched if -v is absent.
 bool shouldWriteGraph(bitset adjacencyList[], int nVertices, bool verboseFlag,
 bool allCyclesFlag, bool K1flag, bool K2flag, int vertexToCheck, int
-vertexPairToCheck[]) {
+vertexPairToCheck[], bool *settledByConnectivity) {
+    if((K1flag || K2flag) && !verboseFlag &&
+     !isKConnected(adjacencyList, nVertices, EMPTY, 3)) {
+        *settledByConnectivity = true;
+        return false;
+    }
     if (K1flag) {
         if(isK1Hamiltonian(adjacencyList, nVertices, verboseFlag,
          allCyclesFlag, vertexToCheck)) {
@@ -97,6 +227,694 @@ vertexPairToCheck[]) {
     return true;
 }
 
+//  The options with which every graph is checked.
+struct options {
+    bool assumeNonHamFlag;
+    bool K1flag;
+    bool K2flag;
+    bool verboseFlag;
+    bool allCyclesFlag;
+    bool complementFlag;
+    bool traceableFlag;
+    int vertexToCheck;
+    int vertexPairToCheck[2];
+    long long int maxNodes;
+    double maxSeconds;
+    FILE *deferredFile;
+    bool timingsFlag;
+    struct slowGraphs *slowGraphs;
+};
+
+//  The phases of checking a graph which are timed by --timings. The K1 and
+//  K2 phases also contain the K1- and K2-traceability checks.
+enum phase {PARSE_PHASE, NON_HAMILTONICITY_PHASE, K1_PHASE, K2_PHASE,
+ NUMBER_OF_PHASES};
+
+const char *phaseNames[NUMBER_OF_PHASES] = {"parse", "non-hamiltonicity",
+ "K1", "K2"};
+
+//  The cost of every phase of checking a single graph, which is collected for
+//  --slow-graphs. While a phase runs, search is used as searchControl.cost.
+struct graphCost {
+    struct searchCost search;
+    bool checked[NUMBER_OF_PHASES];
+    long long int nodes[NUMBER_OF_PHASES];
+    double wallTime[NUMBER_OF_PHASES];
+    long long int dominatingNodes[NUMBER_OF_PHASES];
+    bitset dominatingSubgraph[NUMBER_OF_PHASES];
+};
+
+//  A graph kept by --slow-graphs together with its cost in one phase. The
+//  graph string does not end with a newline.
+struct slowGraph {
+    char *graphString;
+    unsigned long long int lineNumber;
+    long long int nodes;
+    double wallTime;
+    long long int dominatingNodes;
+    bitset dominatingSubgraph;
+};
+
+//  For every phase, the at most capacity most expensive graphs so far. These
+//  are kept in a heap of which the root is the cheapest graph, so that it can
+//  be replaced as soon as a more expensive one is found.
+struct slowGraphs {
+    pthread_mutex_t mutex;
+    int capacity;
+    int numberOfGraphs[NUMBER_OF_PHASES];
+    struct slowGraph *heaps[NUMBER_OF_PHASES];
+};
+
+//  Graphs are ordered by their number of nodes and then by their time.
+bool isCheaper(struct slowGraph *graph, struct slowGraph *otherGraph) {
+    return graph->nodes < otherGraph->nodes || (graph->nodes ==
+     otherGraph->nodes && graph->wallTime < otherGraph->wallTime);
+}
+
+void swapSlowGraphs(struct slowGraph *graph, struct slowGraph *otherGraph) {
+    struct slowGraph temporary = *graph;
+    *graph = *otherGraph;
+    *otherGraph = temporary;
+}
+
+//  Restore the heap property after the graph at index became cheaper.
+void siftDown(struct slowGraph heap[], int numberOfGraphs, int index) {
+    while(1) {
+        int cheapest = index;
+        for(int child = 2 * index + 1; child <= 2 * index + 2 &&
+         child < numberOfGraphs; child++) {
+            if(isCheaper(&heap[child], &heap[cheapest])) {
+                cheapest = child;
+            }
+        }
+        if(cheapest == index) {
+            return;
+        }
+        swapSlowGraphs(&heap[index], &heap[cheapest]);
+        index = cheapest;
+    }
+}
+
+//  Restore the heap property after the graph at index was added.
+void siftUp(struct slowGraph heap[], int index) {
+    while(index > 0 && isCheaper(&heap[index], &heap[(index - 1) / 2])) {
+        swapSlowGraphs(&heap[index], &heap[(index - 1) / 2]);
+        index = (index - 1) / 2;
+    }
+}
+
+struct slowGraphs *newSlowGraphs(int capacity) {
+    struct slowGraphs *slowGraphs = calloc(1, sizeof(struct slowGraphs));
+    if(slowGraphs == NULL) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    pthread_mutex_init(&slowGraphs->mutex, NULL);
+    slowGraphs->capacity = capacity;
+    for(int i = 0; i < NUMBER_OF_PHASES; i++) {
+        slowGraphs->heaps[i] = malloc(capacity * sizeof(struct slowGraph));
+        if(slowGraphs->heaps[i] == NULL) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+    }
+    return slowGraphs;
+}
+
+//  Keep the graph for every phase in which it is one of the most expensive
+//  graphs so far. Parsing is not considered.
+void offerSlowGraph(struct slowGraphs *slowGraphs, const char *graphString,
+unsigned long long int lineNumber, struct graphCost *cost) {
+    pthread_mutex_lock(&slowGraphs->mutex);
+    for(int phase = NON_HAMILTONICITY_PHASE; phase < NUMBER_OF_PHASES;
+     phase++) {
+        if(!cost->checked[phase]) {
+            continue;
+        }
+        struct slowGraph graph = {.lineNumber = lineNumber, .nodes =
+         cost->nodes[phase], .wallTime = cost->wallTime[phase],
+         .dominatingNodes = cost->dominatingNodes[phase],
+         .dominatingSubgraph = cost->dominatingSubgraph[phase]};
+        struct slowGraph *heap = slowGraphs->heaps[phase];
+        int *numberOfGraphs = &slowGraphs->numberOfGraphs[phase];
+        if(*numberOfGraphs == slowGraphs->capacity &&
+         !isCheaper(&heap[0], &graph)) {
+            continue;
+        }
+        graph.graphString = strndup(graphString, strcspn(graphString, "\n"));
+        if(graph.graphString == NULL) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+        if(*numberOfGraphs == slowGraphs->capacity) {
+            free(heap[0].graphString);
+            heap[0] = graph;
+            siftDown(heap, *numberOfGraphs, 0);
+        }
+        else {
+            heap[*numberOfGraphs] = graph;
+            siftUp(heap, (*numberOfGraphs)++);
+        }
+    }
+    pthread_mutex_unlock(&slowGraphs->mutex);
+}
+
+//  Write the kept graphs of every phase to file, the most expensive first,
+//  and free them.
+void writeSlowGraphs(FILE *file, struct slowGraphs *slowGraphs) {
+    for(int phase = 0; phase < NUMBER_OF_PHASES; phase++) {
+        struct slowGraph *heap = slowGraphs->heaps[phase];
+
+        //  Repeatedly moving the root to the end sorts the heap from the
+        //  most expensive to the cheapest graph.
+        for(int i = slowGraphs->numberOfGraphs[phase] - 1; i > 0; i--) {
+            swapSlowGraphs(&heap[0], &heap[i]);
+            siftDown(heap, i, 0);
+        }
+        for(int i = 0; i < slowGraphs->numberOfGraphs[phase]; i++) {
+            fprintf(file, "%s\tphase=%s\tnodes=%lld\tseconds=%f\tline=%llu"
+             "\tsubgraph=", heap[i].graphString, phaseNames[phase],
+             heap[i].nodes, heap[i].wallTime, heap[i].lineNumber);
+            if(heap[i].dominatingNodes < 0) {
+                fprintf(file, "-\n");
+            }
+            else {
+                fprintf(file, "G");
+                forEach(vertex, heap[i].dominatingSubgraph) {
+                    fprintf(file, "-%d", vertex);
+                }
+                fprintf(file, "\tsubgraphNodes=%lld\n",
+                 heap[i].dominatingNodes);
+            }
+            free(heap[i].graphString);
+        }
+        free(heap);
+    }
+    pthread_mutex_destroy(&slowGraphs->mutex);
+    free(slowGraphs);
+}
+
+//  The numbers reported at the end of the run.
+struct counters {
+    unsigned long long int counter;
+    unsigned long long int nonHamiltonianCounter;
+    unsigned long long int amountPassed;
+    unsigned long long int skippedGraphs;
+    unsigned long long int settledByConnectivity;
+    unsigned long long int deferredGraphs;
+
+    //  Per phase, how often it was timed, its total wall-clock time and the
+    //  total CPU time of the threads checking the graphs.
+    unsigned long long int phaseCalls[NUMBER_OF_PHASES];
+    double wallTime[NUMBER_OF_PHASES];
+    double cpuTime[NUMBER_OF_PHASES];
+};
+
+void addTimes(struct counters *total, struct counters *part) {
+    for(int i = 0; i < NUMBER_OF_PHASES; i++) {
+        total->phaseCalls[i] += part->phaseCalls[i];
+        total->wallTime[i] += part->wallTime[i];
+        total->cpuTime[i] += part->cpuTime[i];
+    }
+}
+
+void addCounters(struct counters *total, struct counters *part) {
+    total->counter += part->counter;
+    total->nonHamiltonianCounter += part->nonHamiltonianCounter;
+    total->amountPassed += part->amountPassed;
+    total->skippedGraphs += part->skippedGraphs;
+    total->settledByConnectivity += part->settledByConnectivity;
+    total->deferredGraphs += part->deferredGraphs;
+    addTimes(total, part);
+}
+
+double secondsOfClock(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+//  The wall-clock time, CPU time and search nodes at which a phase started.
+struct phaseTimer {
+    double wallStart;
+    double cpuStart;
+    long long int nodesStart;
+};
+
+//  Starts timing a phase for --timings and, if cost is not NULL, measuring
+//  its cost for --slow-graphs.
+void startPhase(struct options *options, struct phaseTimer *timer, struct
+graphCost *cost) {
+    if(options->timingsFlag || cost != NULL) {
+        timer->wallStart = secondsOfClock(CLOCK_MONOTONIC);
+        timer->cpuStart = secondsOfClock(CLOCK_THREAD_CPUTIME_ID);
+    }
+    if(cost != NULL) {
+        timer->nodesStart = searchNodesOfThread();
+        cost->search.dominatingNodes = -1;
+        cost->search.dominatingSubgraph = EMPTY;
+    }
+}
+
+void stopPhase(struct options *options, struct phaseTimer *timer, struct
+counters *counters, struct graphCost *cost, enum phase phase) {
+    if(!options->timingsFlag && cost == NULL) {
+        return;
+    }
+    double wallTime = secondsOfClock(CLOCK_MONOTONIC) - timer->wallStart;
+    if(options->timingsFlag) {
+        counters->phaseCalls[phase]++;
+        counters->wallTime[phase] += wallTime;
+        counters->cpuTime[phase] += secondsOfClock(CLOCK_THREAD_CPUTIME_ID) -
+         timer->cpuStart;
+    }
+    if(cost != NULL) {
+        cost->checked[phase] = true;
+        cost->nodes[phase] = searchNodesOfThread() - timer->nodesStart;
+        cost->wallTime[phase] = wallTime;
+        cost->dominatingNodes[phase] = cost->search.dominatingNodes;
+        cost->dominatingSubgraph[phase] = cost->search.dominatingSubgraph;
+    }
+}
+
+//  The categories under which the counters are reported by --progress.
+void reportCounters(struct counters *counters) {
+    unsigned long long int categoryCounts[] = {
+     counters->nonHamiltonianCounter, counters->amountPassed,
+     counters->deferredGraphs};
+    reportCheckedGraphs(counters->counter, categoryCounts);
+}
+
+//  Determine whether the loaded graph passes through the filter.
+bool filterGraph(bitset adjacencyList[], int nVertices, struct options
+*options, struct counters *counters, struct graphCost *cost, bool
+*settledByConnectivity) {
+    struct phaseTimer timer = {0};
+    if(options->traceableFlag) {
+        startPhase(options, &timer, cost);
+        bool isNonTraceableGraph = isNonTraceableOrAssumedNonTraceable(
+         adjacencyList, nVertices, options->verboseFlag,
+         options->assumeNonHamFlag, options->allCyclesFlag,
+         settledByConnectivity);
+        stopPhase(options, &timer, counters, cost, NON_HAMILTONICITY_PHASE);
+        if(isNonTraceableGraph) {
+            counters->nonHamiltonianCounter++;
+            if(options->K1flag) {
+
+                //  K1-traceable graphs are 2-connected.
+                startPhase(options, &timer, cost);
+                bool isK1TraceableGraph;
+                if(!options->verboseFlag &&
+                 !isKConnected(adjacencyList, nVertices, EMPTY, 2)) {
+                    *settledByConnectivity = true;
+                    isK1TraceableGraph = false;
+                }
+                else {
+                    isK1TraceableGraph = isK1Traceable(adjacencyList,
+                     nVertices, options->allCyclesFlag, options->verboseFlag,
+                     options->vertexToCheck);
+                }
+                stopPhase(options, &timer, counters, cost, K1_PHASE);
+                if(isK1TraceableGraph) {
+                    if(!options->complementFlag) {
+                        counters->amountPassed++;
+                        return true;
+                    }
+                }
+                else if(options->complementFlag) {
+                    counters->amountPassed++;
+                    return true;
+                }
+                return false;
+            }
+            if(options->K2flag) {
+
+                //  K2-traceable graphs on more than 4 vertices are
+                //  2-connected.
+                startPhase(options, &timer, cost);
+                bool isK2TraceableGraph;
+                if(!options->verboseFlag && nVertices > 4 &&
+                 !isKConnected(adjacencyList, nVertices, EMPTY, 2)) {
+                    *settledByConnectivity = true;
+                    isK2TraceableGraph = false;
+                }
+                else {
+                    isK2TraceableGraph = isK2Traceable(adjacencyList,
+                     nVertices, options->allCyclesFlag, options->verboseFlag,
+                     options->vertexPairToCheck);
+                }
+                stopPhase(options, &timer, counters, cost, K2_PHASE);
+                if(isK2TraceableGraph) {
+                    if(!options->complementFlag) {
+                        counters->amountPassed++;
+                        return true;
+                    }
+                }
+                else if(options->complementFlag) {
+                    counters->amountPassed++;
+                    return true;
+                }
+                return false;
+            }
+            return !options->complementFlag;
+        }
+        if(options->complementFlag) {
+            counters->amountPassed++;
+            return true;
+        }
+        return false;
+    }
+
+    startPhase(options, &timer, cost);
+    bool isNonHamiltonianGraph = isNonHamOrAssumedNonHam(adjacencyList,
+     nVertices, options->verboseFlag, options->assumeNonHamFlag,
+     options->allCyclesFlag, settledByConnectivity);
+    stopPhase(options, &timer, counters, cost, NON_HAMILTONICITY_PHASE);
+    if(isNonHamiltonianGraph) {
+        counters->nonHamiltonianCounter++;
+        startPhase(options, &timer, cost);
+        bool shouldWrite = shouldWriteGraph(adjacencyList, nVertices,
+         options->verboseFlag, options->allCyclesFlag, options->K1flag,
+         options->K2flag, options->vertexToCheck, options->vertexPairToCheck,
+         settledByConnectivity);
+        if(options->K1flag || options->K2flag) {
+            stopPhase(options, &timer, counters, cost, options->K1flag ?
+             K1_PHASE : K2_PHASE);
+        }
+        if(shouldWrite) {
+            if(!options->complementFlag) {
+                counters->amountPassed++;
+                return true;
+            }
+        }
+        else if(options->complementFlag) {
+            counters->amountPassed++;
+            return true;
+        }
+        return false;
+    }
+
+    //  If we print complements, a hamiltonian graph should always be written.
+    if(options->complementFlag) {
+        counters->amountPassed++;
+        return true;
+    }
+    return false;
+}
+
+//  Load the graph in graphString and determine whether it passes through the
+//  filter. Returns true if the graph should be written to stdout. If the
+//  searches for the graph exceed the limits of --max-nodes or --max-seconds,
+//  false is returned and deferred is set instead. Such a graph only counts as
+//  checked. The graph is on line lineNumber of the input.
+bool checkGraph(const char *graphString, unsigned long long int lineNumber,
+struct options *options, struct counters *counters, bool *deferred) {
+    *deferred = false;
+    struct phaseTimer timer = {0};
+    startPhase(options, &timer, NULL);
+    int nVertices = getNumberOfVertices(graphString);
+    if(nVertices == -1 || nVertices > MAXVERTICES) {
+        if(options->verboseFlag){
+            fprintf(stderr, "Skipping invalid graph!\n");
+        }
+        counters->skippedGraphs++;
+        return false;
+    }
+    bitset adjacencyList[nVertices];
+    if(loadGraph(graphString, nVertices, adjacencyList) == -1) {
+        if(options->verboseFlag){
+            fprintf(stderr, "Skipping invalid graph!\n");
+        }
+        counters->skippedGraphs++;
+        return false;
+    }
+    stopPhase(options, &timer, counters, NULL, PARSE_PHASE);
+    counters->counter++;
+    if(options->verboseFlag || options->allCyclesFlag) {
+        fprintf(stderr, "Looking at: %s", graphString);
+    }
+
+    //  Paths stored in the transposition table for another graph should not
+    //  be used.
+    searchControl.graphNumber = newGraphNumber();
+
+    struct searchBudget budget;
+    if(options->maxNodes || options->maxSeconds) {
+        startSearchBudget(&budget, options->maxNodes, options->maxSeconds);
+        setSearchBudget(&budget);
+    }
+
+    struct graphCost cost = {.search.mutex = PTHREAD_MUTEX_INITIALIZER};
+    if(options->slowGraphs != NULL) {
+        searchControl.cost = &cost.search;
+    }
+
+    struct counters graphCounters = {0};
+    bool settledByConnectivity = false;
+    bool shouldWrite = filterGraph(adjacencyList, nVertices, options,
+     &graphCounters, searchControl.cost ? &cost : NULL,
+     &settledByConnectivity);
+    if(searchControl.cost != NULL) {
+        searchControl.cost = NULL;
+        offerSlowGraph(options->slowGraphs, graphString, lineNumber, &cost);
+    }
+    if(searchControl.budget != NULL) {
+        setSearchBudget(NULL);
+        if(atomic_load(&budget.exceeded)) {
+            addTimes(counters, &graphCounters);
+            counters->deferredGraphs++;
+            *deferred = true;
+            return false;
+        }
+    }
+    addCounters(counters, &graphCounters);
+    if(settledByConnectivity) {
+        counters->settledByConnectivity++;
+    }
+    return shouldWrite;
+}
+
+//  Print the times of the phases and of the whole run, which took wallTime
+//  seconds and cpuTime seconds of CPU time of all threads.
+void printTimings(struct counters *counters, double wallTime, double cpuTime) {
+    fprintf(stderr, "Timings: %f s wall-clock time, %f s CPU time.\n",
+     wallTime, cpuTime);
+    for(int i = 0; i < NUMBER_OF_PHASES; i++) {
+        if(counters->phaseCalls[i] == 0) {
+            continue;
+        }
+        fprintf(stderr, "  %-18s %12lld calls, %f s wall-clock, %f s CPU.\n",
+         phaseNames[i], counters->phaseCalls[i], counters->wallTime[i],
+         counters->cpuTime[i]);
+    }
+}
+
+void writeTimingsJson(FILE *file, struct counters *counters, double wallTime,
+double cpuTime) {
+    fprintf(file, "{\n  \"graphs\": %lld,\n  \"wallSeconds\": %f,\n"
+     "  \"cpuSeconds\": %f,\n  \"phases\": {", counters->counter, wallTime,
+     cpuTime);
+    for(int i = 0; i < NUMBER_OF_PHASES; i++) {
+        fprintf(file, "%s\n    \"%s\": {\"calls\": %lld, \"wallSeconds\": %f, "
+         "\"cpuSeconds\": %f}", i ? "," : "", phaseNames[i],
+         counters->phaseCalls[i], counters->wallTime[i], counters->cpuTime[i]);
+    }
+    fprintf(file, "\n  }\n}\n");
+}
+
+//  Number of consecutive graphs of the input which are handed to a worker
+//  thread at once.
+#define BATCHSIZE 32
+
+struct batch {
+    unsigned long long int number;
+    int numberOfGraphs;
+    char *graphStrings[BATCHSIZE];
+    unsigned long long int lineNumbers[BATCHSIZE];
+    bool shouldWrite[BATCHSIZE];
+    bool deferred[BATCHSIZE];
+    struct counters counters;
+
+    //  The number of lines and bytes of the input up to the last graph of
+    //  the batch.
+    unsigned long long int lines;
+    unsigned long long int bytes;
+};
+
+//  The reader thread puts batches of graphs in a bounded queue from which the
+//  workers take them. Finished batches are put in a reorder buffer, from which
+//  they are written to stdout in the order in which they were read. At most
+//  capacity batches can be read but not yet written, so every such batch has
+//  its own slot in the queue and in the reorder buffer.
+struct pipeline {
+    struct options *options;
+    int capacity;
+
+    pthread_mutex_t queueMutex;
+    pthread_cond_t queueNotEmpty;
+    struct batch **queue;
+    int head;
+    int numberInQueue;
+    bool endOfInput;
+
+    pthread_mutex_t outputMutex;
+    pthread_cond_t slotFreed;
+    struct batch **reorderBuffer;
+    unsigned long long int numberOfBatchesRead;
+    unsigned long long int nextBatchToWrite;
+    struct counters counters;
+};
+
+//  Called by the reader. Blocks until fewer than capacity batches are
+//  waiting to be written.
+void submitBatch(struct pipeline *pipeline, struct batch *batch) {
+    pthread_mutex_lock(&pipeline->outputMutex);
+    while(pipeline->numberOfBatchesRead - pipeline->nextBatchToWrite >=
+     (unsigned long long int) pipeline->capacity) {
+        pthread_cond_wait(&pipeline->slotFreed, &pipeline->outputMutex);
+    }
+    batch->number = pipeline->numberOfBatchesRead++;
+    pthread_mutex_unlock(&pipeline->outputMutex);
+
+    pthread_mutex_lock(&pipeline->queueMutex);
+    pipeline->queue[(pipeline->head + pipeline->numberInQueue) %
+     pipeline->capacity] = batch;
+    pipeline->numberInQueue++;
+    pthread_cond_signal(&pipeline->queueNotEmpty);
+    pthread_mutex_unlock(&pipeline->queueMutex);
+}
+
+//  Put a checked batch in the reorder buffer and write all batches which are
+//  next in line.
+void finishBatch(struct pipeline *pipeline, struct batch *batch) {
+    pthread_mutex_lock(&pipeline->outputMutex);
+    pipeline->reorderBuffer[batch->number % pipeline->capacity] = batch;
+    struct batch *nextBatch;
+    while((nextBatch = pipeline->reorderBuffer[pipeline->nextBatchToWrite %
+     pipeline->capacity]) != NULL) {
+        for(int i = 0; i < nextBatch->numberOfGraphs; i++) {
+            if(nextBatch->shouldWrite[i]) {
+                printf("%s", nextBatch->graphStrings[i]);
+            }
+            else if(nextBatch->deferred[i] && pipeline->options->deferredFile) {
+                fprintf(pipeline->options->deferredFile, "%s",
+                 nextBatch->graphStrings[i]);
+            }
+            free(nextBatch->graphStrings[i]);
+        }
+        addCounters(&pipeline->counters, &nextBatch->counters);
+        reportInput(nextBatch->lines, nextBatch->bytes);
+        reportCounters(&pipeline->counters);
+        pipeline->reorderBuffer[pipeline->nextBatchToWrite %
+         pipeline->capacity] = NULL;
+        pipeline->nextBatchToWrite++;
+        free(nextBatch);
+    }
+    pthread_cond_signal(&pipeline->slotFreed);
+    pthread_mutex_unlock(&pipeline->outputMutex);
+}
+
+void *worker(void *argument) {
+    struct pipeline *pipeline = argument;
+    while(1) {
+        pthread_mutex_lock(&pipeline->queueMutex);
+        while(pipeline->numberInQueue == 0 && !pipeline->endOfInput) {
+            pthread_cond_wait(&pipeline->queueNotEmpty, &pipeline->queueMutex);
+        }
+        if(pipeline->numberInQueue == 0) {
+            pthread_mutex_unlock(&pipeline->queueMutex);
+            return NULL;
+        }
+        struct batch *batch = pipeline->queue[pipeline->head];
+        pipeline->head = (pipeline->head + 1) % pipeline->capacity;
+        pipeline->numberInQueue--;
+        pthread_mutex_unlock(&pipeline->queueMutex);
+
+        for(int i = 0; i < batch->numberOfGraphs; i++) {
+            batch->shouldWrite[i] = checkGraph(batch->graphStrings[i],
+             batch->lineNumbers[i], pipeline->options, &batch->counters,
+             &batch->deferred[i]);
+        }
+        finishBatch(pipeline, batch);
+    }
+}
+
+//  Read the graphs of stdin in the calling thread and check them on
+//  numberOfThreads worker threads.
+void checkGraphsInParallel(int numberOfThreads, struct
+options *options, int mod, int res, struct counters *counters) {
+    struct pipeline pipeline = {.options = options,
+     .capacity = 4 * numberOfThreads};
+    pthread_mutex_init(&pipeline.queueMutex, NULL);
+    pthread_cond_init(&pipeline.queueNotEmpty, NULL);
+    pthread_mutex_init(&pipeline.outputMutex, NULL);
+    pthread_cond_init(&pipeline.slotFreed, NULL);
+    pipeline.queue = calloc(pipeline.capacity, sizeof(struct batch *));
+    pipeline.reorderBuffer = calloc(pipeline.capacity, sizeof(struct batch *));
+    if(pipeline.queue == NULL || pipeline.reorderBuffer == NULL) {
+        fprintf(stderr, "Error: Could not allocate the queue.\n");
+        exit(1);
+    }
+
+    pthread_t threads[numberOfThreads];
+    for(int i = 0; i < numberOfThreads; i++) {
+        if(pthread_create(&threads[i], NULL, worker, &pipeline)) {
+            fprintf(stderr, "Error: Could not create thread.\n");
+            exit(1);
+        }
+    }
+
+    unsigned long long int total = 0;
+    unsigned long long int bytes = 0;
+    struct batch *batch = NULL;
+    char *graphString = NULL;
+    size_t size = 0;
+    ssize_t length;
+    while((length = getline(&graphString, &size, stdin)) != -1) {
+        bytes += length;
+
+        //  If for graph n: n % mod != res, skip the graph.
+        if (total++ % mod != res) {
+            continue;
+        }
+        if(batch == NULL) {
+            batch = calloc(1, sizeof(struct batch));
+            if(batch == NULL) {
+                fprintf(stderr, "Error: Could not allocate batch.\n");
+                exit(1);
+            }
+        }
+
+        //  The batch takes ownership of the line.
+        batch->lineNumbers[batch->numberOfGraphs] = total;
+        batch->graphStrings[batch->numberOfGraphs++] = graphString;
+        batch->lines = total;
+        batch->bytes = bytes;
+        graphString = NULL;
+        size = 0;
+        if(batch->numberOfGraphs == BATCHSIZE) {
+            submitBatch(&pipeline, batch);
+            batch = NULL;
+        }
+    }
+    free(graphString);
+    if(batch != NULL) {
+        submitBatch(&pipeline, batch);
+    }
+
+    pthread_mutex_lock(&pipeline.queueMutex);
+    pipeline.endOfInput = true;
+    pthread_cond_broadcast(&pipeline.queueNotEmpty);
+    pthread_mutex_unlock(&pipeline.queueMutex);
+    for(int i = 0; i < numberOfThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    addCounters(counters, &pipeline.counters);
+    free(pipeline.queue);
+    free(pipeline.reorderBuffer);
+}
+
 int main(int argc, char ** argv) {
     bool assumeNonHamFlag = false;
     bool K1flag = false;
@@ -109,6 +927,16 @@ int main(int argc, char ** argv) {
     int mod, res;
     int vertexToCheck = -1;
     int vertexPairToCheck[2] = {-1,-1};
+    int numberOfThreads = 1;
+    int connectivityCheckInterval = 0;
+    long long int maxNodes = 0;
+    double maxSeconds = 0;
+    char *deferredFileName = NULL;
+    double progressInterval = 0;
+    bool timingsFlag = false;
+    char *timingsFileName = NULL;
+    char *slowGraphsFileName = NULL;
+    int slowGraphsCount = 10;
     int opt;
     while (1) {
         int option_index = 0;
@@ -120,7 +948,46 @@ int main(int argc, char ** argv) {
             {"complement",              no_argument, NULL,  'c'},
             {"help",                    no_argument, NULL,  'h'},
             {"assume-non-hamiltonian",  no_argument, NULL,  'n'},
+            {"subgraph-threads",        required_argument, NULL,
+             SUBGRAPH_THREADS_OPTION},
+            {"search-threads",          required_argument, NULL,
+             SEARCH_THREADS_OPTION},
+            {"forced-edges",            no_argument, NULL,
+             FORCED_EDGES_OPTION},
+            {"bidirectional",           no_argument, NULL,
+             BIDIRECTIONAL_OPTION},
+            {"connectivity-check",      required_argument, NULL,
+             CONNECTIVITY_CHECK_OPTION},
+            {"articulation-check",      no_argument, NULL,
+             ARTICULATION_CHECK_OPTION},
+            {"held-karp",               required_argument, NULL,
+             HELD_KARP_OPTION},
+            {"posa",                    required_argument, NULL,
+             POSA_OPTION},
+            {"lift-cycles",             no_argument, NULL,
+             LIFT_CYCLES_OPTION},
+            {"skip-search",             no_argument, NULL,
+             SKIP_SEARCH_OPTION},
+            {"orbits",                  no_argument, NULL,  ORBITS_OPTION},
+            {"max-nodes",               required_argument, NULL,
+             MAX_NODES_OPTION},
+            {"max-seconds",             required_argument, NULL,
+             MAX_SECONDS_OPTION},
+            {"deferred",                required_argument, NULL,
+             DEFERRED_OPTION},
+            {"progress",                required_argument, NULL,
+             PROGRESS_OPTION},
+            {"timings",                 no_argument, NULL,  TIMINGS_OPTION},
+            {"timings-json",            required_argument, NULL,
+             TIMINGS_JSON_OPTION},
+            {"slow-graphs",             required_argument, NULL,
+             SLOW_GRAPHS_OPTION},
+            {"slow-graphs-count",       required_argument, NULL,
+             SLOW_GRAPHS_COUNT_OPTION},
             {"traceable",               no_argument, NULL,  't'},
+            {"transposition-table",     required_argument, NULL,
+             TRANSPOSITION_TABLE_OPTION},
+            {"threads",                 required_argument, NULL, THREADS_OPTION},
             {"verbose",                 optional_argument, NULL, 'v'},
             {NULL,                      0,           NULL,    0}
         };
@@ -161,6 +1028,156 @@ int main(int argc, char ** argv) {
                     vertexToCheck = -1;
                 }; 
                 break;
+            case THREADS_OPTION:
+                if(sscanf(optarg, "%d", &numberOfThreads) != 1 ||
+                 numberOfThreads < 1) {
+                    fprintf(stderr, "Error: Invalid number of threads: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case SUBGRAPH_THREADS_OPTION:
+                if(sscanf(optarg, "%d", &searchSettings.subgraphThreads) != 1
+                 || searchSettings.subgraphThreads < 1) {
+                    fprintf(stderr, "Error: Invalid number of threads: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case SEARCH_THREADS_OPTION:
+                if(sscanf(optarg, "%d", &searchSettings.searchThreads) != 1
+                 || searchSettings.searchThreads < 1) {
+                    fprintf(stderr, "Error: Invalid number of threads: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case FORCED_EDGES_OPTION:
+                searchSettings.forcedEdgePropagation = true;
+                break;
+            case BIDIRECTIONAL_OPTION:
+                searchSettings.bidirectionalExtension = true;
+                break;
+            case CONNECTIVITY_CHECK_OPTION:
+                if(sscanf(optarg, "%d", &connectivityCheckInterval) != 1
+                 || connectivityCheckInterval < 1) {
+                    fprintf(stderr, "Error: Invalid interval: %s\n", optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                for(int i = 0; i < NUMBER_OF_SEARCH_ENGINES; i++) {
+                    searchSettings.connectivityCheckInterval[i] =
+                     connectivityCheckInterval;
+                }
+                break;
+            case ARTICULATION_CHECK_OPTION:
+                searchSettings.articulationCheck = true;
+                break;
+            case HELD_KARP_OPTION:
+                if(sscanf(optarg, "%d", &searchSettings.heldKarpMaxOrder) != 1
+                 || searchSettings.heldKarpMaxOrder < 0
+                 || searchSettings.heldKarpMaxOrder > HELDKARPMAXORDER) {
+                    fprintf(stderr, "Error: Invalid order: %s\n", optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case TRANSPOSITION_TABLE_OPTION:
+                if(sscanf(optarg, "%d", &searchSettings.transpositionTableSize)
+                 != 1 || searchSettings.transpositionTableSize < 1) {
+                    fprintf(stderr, "Error: Invalid size: %s\n", optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case POSA_OPTION:
+                if(sscanf(optarg, "%d", &searchSettings.posaBudget) != 1
+                 || searchSettings.posaBudget < 1) {
+                    fprintf(stderr, "Error: Invalid budget: %s\n", optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case LIFT_CYCLES_OPTION:
+                searchSettings.liftCycles = true;
+                break;
+            case SKIP_SEARCH_OPTION:
+                searchSettings.skipSearch = true;
+                break;
+            case ORBITS_OPTION:
+                searchSettings.orbitReduction = true;
+                break;
+            case MAX_NODES_OPTION:
+                if(sscanf(optarg, "%lld", &maxNodes) != 1 || maxNodes < 1) {
+                    fprintf(stderr, "Error: Invalid number of nodes: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case MAX_SECONDS_OPTION:
+                if(sscanf(optarg, "%lf", &maxSeconds) != 1 || maxSeconds <= 0) {
+                    fprintf(stderr, "Error: Invalid number of seconds: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case DEFERRED_OPTION:
+                deferredFileName = optarg;
+                break;
+            case TIMINGS_OPTION:
+                timingsFlag = true;
+                break;
+            case TIMINGS_JSON_OPTION:
+                timingsFileName = optarg;
+                break;
+            case SLOW_GRAPHS_OPTION:
+                slowGraphsFileName = optarg;
+                break;
+            case SLOW_GRAPHS_COUNT_OPTION:
+                if(sscanf(optarg, "%d", &slowGraphsCount) != 1 ||
+                 slowGraphsCount < 1) {
+                    fprintf(stderr, "Error: Invalid number of graphs: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
+            case PROGRESS_OPTION:
+                if(sscanf(optarg, "%lf", &progressInterval) != 1 ||
+                 progressInterval <= 0) {
+                    fprintf(stderr, "Error: Invalid number of seconds: %s\n",
+                     optarg);
+                    fprintf(stderr, "%s\n", USAGE);
+                    fprintf(stderr,
+                     "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
+                    return 1;
+                }
+                break;
             case '?':
                 fprintf(stderr,"Error: Unknown option: %c\n", optopt);
                 fprintf(stderr, "%s\n", USAGE);
@@ -206,17 +1223,17 @@ int main(int argc, char ** argv) {
         return 1;
     }
 
-    if (optionsNumber == 10 || optionsNumber == 14) {
-        fprintf(stderr,"Error: Not yet implemented.\n");
+    //  Only -n or -t and -n are present
+    if(optionsNumber % 8 == 4) {
+        fprintf(stderr,"Error: Use this flag only in combination with -1 or -2.\n");
         fprintf(stderr, "%s\n", USAGE);
         fprintf(stderr,
          "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
         return 1;
     }
 
-    //  Only -n or -t and -n are present
-    if(optionsNumber % 8 == 4) {
-        fprintf(stderr,"Error: Use this flag only in combination with -1 or -2.\n");
+    if(numberOfThreads > 1 && (verboseFlag || allCyclesFlag)) {
+        fprintf(stderr,"Error: Do not use -v or -a with --threads.\n");
         fprintf(stderr, "%s\n", USAGE);
         fprintf(stderr,
          "Use ./hamiltonicityChecker --help for more detailed instructions.\n");
@@ -243,98 +1260,92 @@ int main(int argc, char ** argv) {
          "Warning: For graphs up to 64 vertices, the 64 bit version of this program is faster.\n");
     }
 
-    unsigned long long int counter = 0;
-    unsigned long long int total = 0;
-    unsigned long long int nonHamiltonianCounter = 0;
-    unsigned long long int amountPassed = 0;
-    unsigned long long int skippedGraphs = 0;
+    FILE *deferredFile = NULL;
+    if(deferredFileName != NULL) {
+        deferredFile = fopen(deferredFileName, "a");
+        if(deferredFile == NULL) {
+            fprintf(stderr, "Error: Could not open %s.\n", deferredFileName);
+            return 1;
+        }
+    }
+
+    FILE *timingsFile = NULL;
+    if(timingsFileName != NULL) {
+        timingsFile = fopen(timingsFileName, "w");
+        if(timingsFile == NULL) {
+            fprintf(stderr, "Error: Could not open %s.\n", timingsFileName);
+            return 1;
+        }
+    }
+
+    FILE *slowGraphsFile = NULL;
+    struct slowGraphs *slowGraphs = NULL;
+    if(slowGraphsFileName != NULL) {
+        slowGraphsFile = fopen(slowGraphsFileName, "w");
+        if(slowGraphsFile == NULL) {
+            fprintf(stderr, "Error: Could not open %s.\n", slowGraphsFileName);
+            return 1;
+        }
+        slowGraphs = newSlowGraphs(slowGraphsCount);
+    }
+
+    struct options options = {.assumeNonHamFlag = assumeNonHamFlag,
+     .K1flag = K1flag, .K2flag = K2flag, .verboseFlag = verboseFlag,
+     .allCyclesFlag = allCyclesFlag, .complementFlag = complementFlag,
+     .traceableFlag = traceableFlag, .vertexToCheck = vertexToCheck,
+     .vertexPairToCheck = {vertexPairToCheck[0], vertexPairToCheck[1]},
+     .maxNodes = maxNodes, .maxSeconds = maxSeconds, .deferredFile =
+     deferredFile, .timingsFlag = timingsFlag || timingsFile != NULL,
+     .slowGraphs = slowGraphs};
+    struct counters counters = {0};
 
     clock_t start = clock();
+    double wallStart = secondsOfClock(CLOCK_MONOTONIC);
 
-    //  Start looping over lines of stdin.
-    char * graphString = NULL;
-    size_t size;
-    while(getline(&graphString, &size, stdin) != -1) {
+    if(progressInterval) {
+        const char *categoryNames[] = {traceableFlag ? "non-traceable" :
+         "non-hamiltonian", "passed", "deferred"};
+        startProgress(progressInterval, maxNodes || maxSeconds ? 3 : 2,
+         categoryNames);
+    }
 
-        //  If for graph n: n % mod != res, skip the graph.
-        if (total++ % mod != res) {
-            continue;
-        }
-        int nVertices = getNumberOfVertices(graphString);
-        if(nVertices == -1 || nVertices > MAXVERTICES) {
-            if(verboseFlag){
-                fprintf(stderr, "Skipping invalid graph!\n");
-            }
-            skippedGraphs++;
-            continue;
-        }
-        bitset adjacencyList[nVertices];
-        if(loadGraph(graphString, nVertices, adjacencyList) == -1) {
-            if(verboseFlag){
-                fprintf(stderr, "Skipping invalid graph!\n");
-            }
-            skippedGraphs++;
-            continue;
-        }
-        counter++;
-        if(verboseFlag || allCyclesFlag) {
-            fprintf(stderr, "Looking at: %s", graphString);
-        }
-
-        if(traceableFlag) {
-            if(isNonTraceableOrAssumedNonTraceable(adjacencyList, nVertices,
-             verboseFlag, assumeNonHamFlag, allCyclesFlag)) {
-                nonHamiltonianCounter++;
-                if(K1flag) {
-                    if(isK1Traceable(adjacencyList, nVertices, allCyclesFlag,
-                     verboseFlag, vertexToCheck)) {
-                        if(!complementFlag) {
-                            printf("%s", graphString);
-                            amountPassed++;
-                        }
-                    }
-                    else if(complementFlag) {
-                        printf("%s", graphString);
-                        amountPassed++;
-                    }
-                }
-                else if(!complementFlag) {
-                    printf("%s", graphString);
-                }
-            }
-            else if(complementFlag) {
-                printf("%s", graphString);
-                amountPassed++;
-            }
-        }
+    if(numberOfThreads > 1) {
+        checkGraphsInParallel(numberOfThreads, &options, mod, res, &counters);
+    }
+    else {
+        unsigned long long int total = 0;
+        unsigned long long int bytes = 0;
 
-        else if(isNonHamOrAssumedNonHam(adjacencyList,nVertices,verboseFlag,
-         assumeNonHamFlag,allCyclesFlag)){
-            nonHamiltonianCounter++;
-            if(shouldWriteGraph(adjacencyList,nVertices,verboseFlag,
-             allCyclesFlag, K1flag, K2flag, vertexToCheck, vertexPairToCheck)) {
-                if(!complementFlag) {
-                    printf("%s", graphString);
-                    amountPassed++;
-                }
+        //  Start looping over lines of stdin.
+        char * graphString = NULL;
+        size_t size;
+        ssize_t length;
+        while((length = getline(&graphString, &size, stdin)) != -1) {
+            bytes += length;
+            reportInput(total + 1, bytes);
+
+            //  If for graph n: n % mod != res, skip the graph.
+            if (total++ % mod != res) {
+                continue;
             }
-            else if(complementFlag) {
+            bool deferred;
+            if(checkGraph(graphString, total, &options, &counters,
+             &deferred)) {
                 printf("%s", graphString);
-                amountPassed++;
             }
+            else if(deferred && deferredFile) {
+                fprintf(deferredFile, "%s", graphString);
+            }
+            reportCounters(&counters);
         }
-
-        //  If we print complements, a hamiltonian graph should always be written.
-        else if(complementFlag) {
-            printf("%s",graphString);
-            amountPassed++;
-        }
-
+        free(graphString);
     }
+    stopProgress();
     clock_t end = clock();
     double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
+    double wallTime = secondsOfClock(CLOCK_MONOTONIC) - wallStart;
 
-    fprintf(stderr,"\rChecked %lld graphs in %f seconds: ", counter, time_spent);
+    fprintf(stderr,"\rChecked %lld graphs in %f seconds: ", counters.counter, time_spent);
 
     char *compString = "";
     if(complementFlag) {
@@ -345,27 +1356,27 @@ int main(int argc, char ** argv) {
         //  hamiltonicity check
         case 0:
             if(!complementFlag) {
-                fprintf(stderr, "%lld are non-hamiltonian, ", nonHamiltonianCounter);
+                fprintf(stderr, "%lld are non-hamiltonian, ", counters.nonHamiltonianCounter);
             }
             else {
-                fprintf(stderr, "%lld are hamiltonian, ", amountPassed);
+                fprintf(stderr, "%lld are hamiltonian, ", counters.amountPassed);
             }
             break;
 
         //  hypohamiltonicity check
         case 1:
             if(!complementFlag) {
-                fprintf(stderr,"%lld are non-hamiltonian, ", nonHamiltonianCounter);
+                fprintf(stderr,"%lld are non-hamiltonian, ", counters.nonHamiltonianCounter);
             }
-            fprintf(stderr,"%lld are %shypohamiltonian, ", amountPassed, compString);
+            fprintf(stderr,"%lld are %shypohamiltonian, ", counters.amountPassed, compString);
             break;
 
         //  K2-hypohamiltonicity check
         case 2:
             if(!complementFlag) {
-                fprintf(stderr,"%lld are non-hamiltonian, ", nonHamiltonianCounter);
+                fprintf(stderr,"%lld are non-hamiltonian, ", counters.nonHamiltonianCounter);
             }
-            fprintf(stderr,"%lld are %sK2-hypohamiltonian, ", amountPassed, compString);
+            fprintf(stderr,"%lld are %sK2-hypohamiltonian, ", counters.amountPassed, compString);
             break;
         case 3:
             //  Cannot occur
@@ -376,11 +1387,11 @@ int main(int argc, char ** argv) {
 
         //  K1-hamiltonicity check
         case 5:
-            fprintf(stderr,"%lld are %sK1-hamiltonian, ", amountPassed, compString);
+            fprintf(stderr,"%lld are %sK1-hamiltonian, ", counters.amountPassed, compString);
             break;
         //  K2-hamiltonicity check
         case 6:
-            fprintf(stderr,"%lld are %sK2-hamiltonian, ", amountPassed, compString);
+            fprintf(stderr,"%lld are %sK2-hamiltonian, ", counters.amountPassed, compString);
             break;
         case 7:
             //  -1 and -2 cannot occur.
@@ -389,22 +1400,27 @@ int main(int argc, char ** argv) {
         //  traceability check
         case 8:
             if(!complementFlag) {
-                fprintf(stderr, "%lld are non-traceable, ", nonHamiltonianCounter);
+                fprintf(stderr, "%lld are non-traceable, ", counters.nonHamiltonianCounter);
             }
             else {
-                fprintf(stderr, "%lld are traceable, ", amountPassed);
+                fprintf(stderr, "%lld are traceable, ", counters.amountPassed);
             }
             break;
 
         //  hypotraceability check
         case 9:
             if(!complementFlag) {
-                fprintf(stderr,"%lld are non-traceable, ", nonHamiltonianCounter);
+                fprintf(stderr,"%lld are non-traceable, ", counters.nonHamiltonianCounter);
             }
-            fprintf(stderr, "%lld are %shypotraceable, ", amountPassed, compString);
+            fprintf(stderr, "%lld are %shypotraceable, ", counters.amountPassed, compString);
             break;
+
+        //  K2-hypotraceability check
         case 10:
-            //  K2-hypotraceability not implemented.
+            if(!complementFlag) {
+                fprintf(stderr,"%lld are non-traceable, ", counters.nonHamiltonianCounter);
+            }
+            fprintf(stderr, "%lld are %sK2-hypotraceable, ", counters.amountPassed, compString);
             break;
         case 11:
             // -1 and -2 cannot occur.
@@ -412,10 +1428,10 @@ int main(int argc, char ** argv) {
             //  Should not occur
             break;
         case 13:
-            fprintf(stderr, "%lld are %sK1-traceable, ", amountPassed, compString);
+            fprintf(stderr, "%lld are %sK1-traceable, ", counters.amountPassed, compString);
             break;
         case 14:
-            //  K2-traceability not implemented.
+            fprintf(stderr, "%lld are %sK2-traceable, ", counters.amountPassed, compString);
             break;
         case 15:
             //  -1 and -2 cannot occur.
@@ -423,9 +1439,66 @@ int main(int argc, char ** argv) {
 
     }
     fprintf(stderr,"\b\b.\n");
-    if(skippedGraphs) {
-        fprintf(stderr, "Warning: %lld graphs could not be read.\n", skippedGraphs);
+    if(counters.skippedGraphs) {
+        fprintf(stderr, "Warning: %lld graphs could not be read.\n", counters.skippedGraphs);
+    }
+    if(maxNodes || maxSeconds) {
+        fprintf(stderr, "%lld graphs exceeded the search limits%s%s.\n",
+         counters.deferredGraphs, deferredFile ? " and were written to " : "",
+         deferredFile ? deferredFileName : "");
+    }
+    if(deferredFile != NULL) {
+        fclose(deferredFile);
+    }
+    if(counters.settledByConnectivity) {
+        fprintf(stderr, "%lld graphs were settled by their connectivity.\n",
+         counters.settledByConnectivity);
+    }
+    if(connectivityCheckInterval) {
+        char *engineNames[NUMBER_OF_SEARCH_ENGINES] = {"canBeHamiltonian",
+         "canBeHamiltonianPrintCycle"};
+        for(int i = 0; i < NUMBER_OF_SEARCH_ENGINES; i++) {
+            fprintf(stderr, "Connectivity check in %s: %lld checks, %lld disconnected, %lld separated.\n",
+             engineNames[i], atomic_load(&connectivityStatistics[i].checks),
+             atomic_load(&connectivityStatistics[i].disconnected),
+             atomic_load(&connectivityStatistics[i].separated));
+        }
+    }
+    if(searchSettings.transpositionTableSize) {
+        fprintf(stderr, "Transposition table: %lld hits, %lld misses, %lld stores.\n",
+         atomic_load(&transpositionStatistics.hits),
+         atomic_load(&transpositionStatistics.misses),
+         atomic_load(&transpositionStatistics.stores));
+    }
+    if(searchSettings.posaBudget) {
+        fprintf(stderr, "Rotation-extension heuristic: found a cycle in %lld of %lld (sub)graphs.\n",
+         atomic_load(&posaStatistics.successes),
+         atomic_load(&posaStatistics.attempts));
+    }
+    if(searchSettings.liftCycles) {
+        fprintf(stderr, "Lifted cycles: settled %lld of %lld (sub)graphs.\n",
+         atomic_load(&witnessStatistics.lifted),
+         atomic_load(&witnessStatistics.attempts));
+    }
+    if(searchSettings.orbitReduction) {
+        fprintf(stderr, "Orbits: skipped %lld of %lld subgraphs.\n",
+         atomic_load(&orbitStatistics.skipped),
+         atomic_load(&orbitStatistics.subgraphs));
+    }
+    if(timingsFlag) {
+        printTimings(&counters, wallTime, time_spent);
+    }
+    if(timingsFile != NULL) {
+        writeTimingsJson(timingsFile, &counters, wallTime, time_spent);
+        fclose(timingsFile);
+    }
+    if(slowGraphsFile != NULL) {
+        writeSlowGraphs(slowGraphsFile, slowGraphs);
+        fclose(slowGraphsFile);
     }
+#ifdef PRUNE_STATISTICS
+    printPruneStatistics();
+#endif
 
     return 0;
 }
\ No newline at end of file
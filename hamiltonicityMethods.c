@@ -8,38 +8,823 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 #include "bitset.h"
 #include "hamiltonicityMethods.h"
+#include "threadPool.h"
+#include "automorphisms.h"
+
+struct searchSettings searchSettings = {.subgraphThreads = 1,
+ .searchThreads = 1, .forcedEdgePropagation = false,
+ .bidirectionalExtension = false,
+ .connectivityCheckInterval = {0}, .articulationCheck = false,
+ .heldKarpMaxOrder = 0, .transpositionTableSize = 0, .posaBudget = 0,
+ .liftCycles = false, .skipSearch = false, .orbitReduction = false,
+ .meetInTheMiddleMemory = 0};
+
+__thread struct searchControl searchControl;
+
+void startSearchBudget(struct searchBudget *budget, long long int maxNodes,
+double maxSeconds) {
+    budget->maxNodes = maxNodes;
+    budget->hasDeadline = maxSeconds > 0;
+    if(budget->hasDeadline) {
+        clock_gettime(CLOCK_MONOTONIC, &budget->deadline);
+        long long int nanoseconds = budget->deadline.tv_nsec +
+         (long long int) ((maxSeconds - (long long int) maxSeconds) * 1e9);
+        budget->deadline.tv_sec += (time_t) maxSeconds + nanoseconds /
+         1000000000;
+        budget->deadline.tv_nsec = nanoseconds % 1000000000;
+    }
+    atomic_init(&budget->nodes, 0);
+    atomic_init(&budget->exceeded, false);
+}
 
-bool canBeHamiltonian(bitset adjacencyList[], bitset remainingVertices, int
-lastElemOfPath, int firstElemOfPath, int numberOfVertices, int pathLength) {
+static bool isExceeded(struct searchBudget *budget) {
+    return budget != NULL && atomic_load_explicit(&budget->exceeded,
+     memory_order_relaxed);
+}
+
+static bool isCancelled(atomic_bool *cancelled) {
+    return cancelled != NULL && atomic_load_explicit(cancelled,
+     memory_order_relaxed);
+}
+
+//  Returns whether the searches of the current thread should give up,
+//  because another search settled the answer or the budget is exceeded.
+static bool searchStopped(void) {
+    return isCancelled(searchControl.cancelled) ||
+     isCancelled(searchControl.parentCancelled) ||
+     isExceeded(searchControl.budget);
+}
+
+//  Marks budget as exceeded if its deadline has passed.
+static void checkDeadline(struct searchBudget *budget) {
+    if(budget == NULL || !budget->hasDeadline) {
+        return;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(now.tv_sec > budget->deadline.tv_sec || (now.tv_sec ==
+     budget->deadline.tv_sec && now.tv_nsec >= budget->deadline.tv_nsec)) {
+        atomic_store(&budget->exceeded, true);
+    }
+}
+
+//  Like searchStopped, but also checks the deadline of the budget. This is
+//  for the engines which do not visit search nodes, so the deadline is not
+//  checked while counting them.
+static bool searchStoppedOrLate(void) {
+    checkDeadline(searchControl.budget);
+    return searchStopped();
+}
+
+struct searchStatistics searchStatistics;
+
+#ifdef PRUNE_STATISTICS
+
+struct pruneStatistics pruneStatistics;
+
+void printPruneStatistics(void) {
+    const char *eventNames[NUMBER_OF_PRUNE_EVENTS] = {"nodes", "cycle",
+     "unclosable", "options", "table", "connectivity", "forced", "exhausted",
+     "closed", "second"};
+    long long int totals[NUMBER_OF_PRUNE_EVENTS] = {0};
+    fprintf(stderr, "Prune statistics per path length:\n%6s", "length");
+    for(int event = 0; event < NUMBER_OF_PRUNE_EVENTS; event++) {
+        fprintf(stderr, " %12s", eventNames[event]);
+    }
+    fprintf(stderr, "\n");
+    for(int length = 0; length <= MAXVERTICES; length++) {
+        long long int counts[NUMBER_OF_PRUNE_EVENTS];
+        bool occurred = false;
+        for(int event = 0; event < NUMBER_OF_PRUNE_EVENTS; event++) {
+            counts[event] = atomic_load(&pruneStatistics.counts[event][length]);
+            totals[event] += counts[event];
+            occurred |= counts[event] != 0;
+        }
+        if(!occurred) {
+            continue;
+        }
+        fprintf(stderr, "%6d", length);
+        for(int event = 0; event < NUMBER_OF_PRUNE_EVENTS; event++) {
+            fprintf(stderr, " %12lld", counts[event]);
+        }
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "%6s", "total");
+    for(int event = 0; event < NUMBER_OF_PRUNE_EVENTS; event++) {
+        fprintf(stderr, " %12lld", totals[event]);
+    }
+    fprintf(stderr, "\n");
+}
+
+#endif
+
+//  The search nodes visited by the current thread which were not yet added
+//  to searchStatistics and the budget.
+static __thread int uncountedNodes;
+
+//  The search nodes of the current thread which were added to
+//  searchStatistics, plus those of the searches it started on other threads.
+static __thread long long int countedNodes;
+
+long long int searchNodesOfThread(void) {
+    return countedNodes + uncountedNodes;
+}
+
+//  Moves the nodes which the current thread visited since it had visited
+//  nodesAtStart to total. A task run by runTasks uses this, so that the
+//  thread which started the tasks can add them to its own count, no matter
+//  which threads ran them.
+static void moveNodesToSearch(long long int nodesAtStart, atomic_llong
+*total) {
+    long long int nodes = searchNodesOfThread() - nodesAtStart;
+    countedNodes -= nodes;
+    atomic_fetch_add_explicit(total, nodes, memory_order_relaxed);
+}
+
+//  Adds the uncounted nodes of the current thread to searchStatistics and
+//  its budget, without checking the limits. This has to happen before the
+//  budget of the thread is replaced, so that the nodes of one graph are not
+//  charged to the budget of the next.
+static void flushSearchNodes(void) {
+    atomic_fetch_add_explicit(&searchStatistics.nodes, uncountedNodes,
+     memory_order_relaxed);
+    countedNodes += uncountedNodes;
+    if(searchControl.budget != NULL) {
+        atomic_fetch_add_explicit(&searchControl.budget->nodes,
+         uncountedNodes, memory_order_relaxed);
+    }
+    uncountedNodes = 0;
+}
+
+void setSearchBudget(struct searchBudget *budget) {
+    flushSearchNodes();
+    searchControl.budget = budget;
+}
+
+//  Counts a search node. Every BUDGETCHECKINTERVAL nodes these are added to
+//  searchStatistics and the budget of the current thread, of which the
+//  limits are then checked.
+static void countSearchNode(void) {
+    if(++uncountedNodes < BUDGETCHECKINTERVAL) {
+        return;
+    }
+    flushSearchNodes();
+    struct searchBudget *budget = searchControl.budget;
+    if(budget == NULL) {
+        return;
+    }
+    if(budget->maxNodes > 0 && atomic_load_explicit(&budget->nodes,
+     memory_order_relaxed) >= budget->maxNodes) {
+        atomic_store(&budget->exceeded, true);
+        return;
+    }
+    checkDeadline(budget);
+}
+
+//  Forced edges of a search node. A vertex not in the path has to be
+//  connected to two of its options in the cycle, an endpoint of the path to
+//  one. Once that many options are left, these edges are forced and all other
+//  options of the vertex are dropped.
+struct forcedEdges {
+    bitset options[MAXVERTICES];
+    bitset forced[MAXVERTICES];
+
+    //  Union-find structure of the paths formed by the forced edges. The
+    //  endpoints of the path of the search node start out in the same
+    //  component.
+    int parent[MAXVERTICES];
+    int componentSize[MAXVERTICES];
+    int numberOfVertices;
+
+    //  Vertices of which the options or forced edges changed.
+    bitset changedVertices;
+};
+
+static int findComponent(struct forcedEdges *edges, int vertex) {
+    while(edges->parent[vertex] != vertex) {
+        edges->parent[vertex] = edges->parent[edges->parent[vertex]];
+        vertex = edges->parent[vertex];
+    }
+    return vertex;
+}
+
+//  Returns false if forcing the edge closes a cycle which does not contain
+//  all vertices.
+static bool forceEdge(struct forcedEdges *edges, int u, int v) {
+    add(edges->forced[u], v);
+    add(edges->forced[v], u);
+    add(edges->changedVertices, u);
+    add(edges->changedVertices, v);
+    int componentOfU = findComponent(edges, u);
+    int componentOfV = findComponent(edges, v);
+    if(componentOfU == componentOfV) {
+        return edges->componentSize[componentOfU] == edges->numberOfVertices;
+    }
+    edges->parent[componentOfV] = componentOfU;
+    edges->componentSize[componentOfU] += edges->componentSize[componentOfV];
+    return true;
+}
+
+//  Determines the forced edges of the search node given by the path until
+//  nothing changes anymore. Returns false if the path cannot be extended to a
+//  hamiltonian cycle. Otherwise extensions will contain the neighbours of
+//  lastElemOfPath with which the path can still be extended.
+static bool determineForcedEdges(bitset adjacencyList[], bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, bitset
+*extensions) {
+    struct forcedEdges edges;
+    bitset vertices = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+    edges.numberOfVertices = size(vertices);
+    edges.changedVertices = vertices;
+    forEach(vertex, vertices) {
+        edges.options[vertex] = difference(intersection(adjacencyList[vertex],
+         remainingVertices), singleton(vertex));
+        edges.forced[vertex] = EMPTY;
+        edges.parent[vertex] = vertex;
+        edges.componentSize[vertex] = 1;
+    }
+    forEach(vertex, remainingVertices) {
+        edges.options[vertex] = intersection(adjacencyList[vertex],
+         difference(vertices, singleton(vertex)));
+    }
+    edges.parent[lastElemOfPath] = firstElemOfPath;
+    edges.componentSize[firstElemOfPath] = 2;
+
+    while(!isEmpty(edges.changedVertices)) {
+        int vertex = next(edges.changedVertices, -1);
+        removeElement(edges.changedVertices, vertex);
+        int requiredEdges = contains(remainingVertices, vertex) ? 2 : 1;
+        if(size(edges.options[vertex]) < requiredEdges ||
+         size(edges.forced[vertex]) > requiredEdges) {
+            return false;
+        }
+        if(size(edges.options[vertex]) == requiredEdges) {
+            bitset newlyForced = difference(edges.options[vertex],
+             edges.forced[vertex]);
+            forEach(neighbour, newlyForced) {
+                if(!forceEdge(&edges, vertex, neighbour)) {
+                    return false;
+                }
+            }
+        }
+        else if(size(edges.forced[vertex]) == requiredEdges) {
+            bitset droppedOptions = difference(edges.options[vertex],
+             edges.forced[vertex]);
+            edges.options[vertex] = edges.forced[vertex];
+            forEach(neighbour, droppedOptions) {
+                removeElement(edges.options[neighbour], vertex);
+                add(edges.changedVertices, neighbour);
+            }
+        }
+    }
+    *extensions = edges.options[lastElemOfPath];
+    return true;
+}
+
+//  Bit-sliced counters which count for every vertex in how many of the added
+//  sets it lies, up to three. Adding a set takes a few unions and
+//  intersections of whole bitsets, which the 128-bit versions perform with
+//  vector instructions, instead of a popcount per vertex.
+struct saturatingCounters {
+    bitset atLeastOnce;
+    bitset atLeastTwice;
+    bitset atLeastThrice;
+};
+
+#define addToCounters(counters, set) do {\
+    (counters).atLeastThrice = union((counters).atLeastThrice,\
+     intersection((counters).atLeastTwice, (set)));\
+    (counters).atLeastTwice = union((counters).atLeastTwice,\
+     intersection((counters).atLeastOnce, (set)));\
+    (counters).atLeastOnce = union((counters).atLeastOnce, (set));\
+} while(0)
+
+//  Returns false if some vertex not in the path cannot be given two
+//  neighbours in the cycle. A vertex with only two possible neighbours is
+//  joined to both of them, so no vertex can be the only option of more
+//  than two such vertices, and no endpoint of the path of more than one.
+//  The options are counted per vertex, so that the check stops at the first
+//  vertex with too few of them, which is where most nodes fail. The forced
+//  edges are then counted for all vertices at once.
+static bool remainingVerticesHaveOptions(bitset adjacencyList[], bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath) {
+    bitset endpoints = union(singleton(firstElemOfPath),
+     singleton(lastElemOfPath));
+    bitset remainingWithFirstAndLast = union(remainingVertices, endpoints);
+    bitset twoOptions = EMPTY;
+    forEach(vertex, remainingVertices) {
+
+        //  If a vertex has only one such neighbour or less, our path cannot
+        //  be extended through this vertex into a hamiltonian cycle.
+        int options = size(intersection(adjacencyList[vertex],
+         remainingWithFirstAndLast));
+        if(options < 2) {
+            return false;
+        }
+        if(options == 2) {
+            add(twoOptions, vertex);
+        }
+    }
+
+    //  Count how often every vertex is forced by a vertex with two options
+    //  and stop as soon as one is forced too often. The endpoints can only
+    //  be forced once, unless the path consists of a single vertex.
+    bitset endpointsForcedOnce = firstElemOfPath == lastElemOfPath ? EMPTY :
+     endpoints;
+    struct saturatingCounters forced = {EMPTY, EMPTY, EMPTY};
+    forEach(vertex, twoOptions) {
+        addToCounters(forced, intersection(adjacencyList[vertex],
+         remainingWithFirstAndLast));
+        if(!isEmpty(union(forced.atLeastThrice,
+         intersection(forced.atLeastTwice, endpointsForcedOnce)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  For every vertex which is not in the path or is one of its endpoints, its
+//  options, i.e. its neighbours among these vertices, and by how many
+//  remaining vertices with exactly two options it is forced. When the path
+//  is extended, only the previous last vertex stops being an option, so
+//  only the counts of its neighbourhood change. These are updated on every
+//  extension and restored when the search backtracks, which makes the check
+//  of remainingVerticesHaveOptions local to that neighbourhood.
+struct optionCounts {
+    uint8_t options[MAXVERTICES];
+    uint8_t forcedBy[MAXVERTICES];
+};
+
+//  Counts the options from scratch and returns the same as
+//  remainingVerticesHaveOptions.
+static bool countOptions(struct optionCounts *counts, bitset adjacencyList[],
+bitset remainingVertices, int lastElemOfPath, int firstElemOfPath) {
+    bitset remainingWithFirstAndLast = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+    forEach(vertex, remainingWithFirstAndLast) {
+        counts->options[vertex] = size(intersection(adjacencyList[vertex],
+         remainingWithFirstAndLast));
+        counts->forcedBy[vertex] = 0;
+    }
+    bool hasOptions = true;
+    forEach(vertex, remainingVertices) {
+        if(counts->options[vertex] < 2) {
+            hasOptions = false;
+        }
+        else if(counts->options[vertex] == 2) {
+            forEach(option, intersection(adjacencyList[vertex],
+             remainingWithFirstAndLast)) {
+                if(++counts->forcedBy[option] > 2) {
+                    hasOptions = false;
+                }
+            }
+        }
+    }
+    return hasOptions && (firstElemOfPath == lastElemOfPath ||
+     (counts->forcedBy[firstElemOfPath] < 2 &&
+     counts->forcedBy[lastElemOfPath] < 2));
+}
+
+//  Updates the counts after the path was extended from previousLast to
+//  lastElemOfPath, which was removed from remainingVertices, and returns the
+//  same as remainingVerticesHaveOptions for the extended path. Only the
+//  vertices whose options changed are checked, the others passed the check
+//  before the extension.
+static bool extendOptionCounts(struct optionCounts *counts, bitset
+adjacencyList[], bitset remainingVertices, int previousLast, int
+lastElemOfPath, int firstElemOfPath) {
+    bitset remainingWithFirstAndLast = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+
+    //  The new last vertex no longer needs two options.
+    if(counts->options[lastElemOfPath] == 2) {
+        forEach(option, intersection(adjacencyList[lastElemOfPath],
+         union(remainingWithFirstAndLast, singleton(previousLast)))) {
+            counts->forcedBy[option]--;
+        }
+    }
+
+    //  A path of one vertex keeps it as its first vertex.
+    bool hasOptions = true;
+    if(previousLast != firstElemOfPath) {
+        bitset neighbours = intersection(adjacencyList[previousLast],
+         remainingWithFirstAndLast);
+        forEach(vertex, neighbours) {
+            counts->options[vertex]--;
+        }
+        forEach(vertex, intersection(neighbours, remainingVertices)) {
+            if(counts->options[vertex] < 2) {
+                hasOptions = false;
+            }
+            else if(counts->options[vertex] == 2) {
+                forEach(option, intersection(adjacencyList[vertex],
+                 remainingWithFirstAndLast)) {
+                    if(++counts->forcedBy[option] > 2) {
+                        hasOptions = false;
+                    }
+                }
+            }
+        }
+    }
+    return hasOptions && counts->forcedBy[firstElemOfPath] < 2 &&
+     counts->forcedBy[lastElemOfPath] < 2;
+}
+
+//  Undoes extendOptionCounts with the same arguments.
+static void retractOptionCounts(struct optionCounts *counts, bitset
+adjacencyList[], bitset remainingVertices, int previousLast, int
+lastElemOfPath, int firstElemOfPath) {
+    bitset remainingWithFirstAndLast = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+    if(previousLast != firstElemOfPath) {
+        bitset neighbours = intersection(adjacencyList[previousLast],
+         remainingWithFirstAndLast);
+        forEach(vertex, intersection(neighbours, remainingVertices)) {
+            if(counts->options[vertex] == 2) {
+                forEach(option, intersection(adjacencyList[vertex],
+                 remainingWithFirstAndLast)) {
+                    counts->forcedBy[option]--;
+                }
+            }
+        }
+        forEach(vertex, neighbours) {
+            counts->options[vertex]++;
+        }
+    }
+    if(counts->options[lastElemOfPath] == 2) {
+        forEach(option, intersection(adjacencyList[lastElemOfPath],
+         union(remainingWithFirstAndLast, singleton(previousLast)))) {
+            counts->forcedBy[option]++;
+        }
+    }
+}
+
+//  The searches keep option counts if the remaining vertices have on
+//  average at most 1 / OPTIONCOUNTSRATIO of them as options.
+#define OPTIONCOUNTSRATIO 4
+
+//  Returns whether the searches for the path should keep option counts.
+//  Updating them takes time in the number of options of the previous last
+//  vertex, and restoring them again, while the check from scratch takes time
+//  in the number of remaining vertices and stops at the first vertex with
+//  too few options. So the counts only pay off in sparse (sub)graphs.
+static bool useOptionCounts(bitset adjacencyList[], bitset remainingVertices,
+int lastElemOfPath, int firstElemOfPath) {
+    bitset remainingWithFirstAndLast = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+    int numberOfRemaining = size(remainingVertices);
+    int options = 0;
+    forEach(vertex, remainingVertices) {
+        options += size(intersection(adjacencyList[vertex],
+         remainingWithFirstAndLast));
+    }
+    return options * OPTIONCOUNTSRATIO <= numberOfRemaining *
+     numberOfRemaining;
+}
+
+struct connectivityStatistics connectivityStatistics[NUMBER_OF_SEARCH_ENGINES];
+
+//  Returns whether the subgraph spanned by the non-empty set vertices is
+//  connected.
+static bool isConnectedSubgraph(bitset adjacencyList[], bitset vertices) {
+    bitset reached = singleton(next(vertices, -1));
+    bitset frontier = reached;
+    while(!isEmpty(frontier)) {
+        bitset neighbours = EMPTY;
+        forEach(vertex, frontier) {
+            neighbours = union(neighbours, adjacencyList[vertex]);
+        }
+        frontier = difference(intersection(neighbours, vertices), reached);
+        reached = union(reached, frontier);
+    }
+    return equals(reached, vertices);
+}
+
+//  Depth-first search used to find the vertices separating the vertices not
+//  in the path from both endpoints.
+struct separationSearch {
+    bitset *adjacencyList;
+    bitset vertices;
+    int firstElemOfPath;
+    int lastElemOfPath;
+    int time;
+    int discovered[MAXVERTICES];
+    int low[MAXVERTICES];
+    bool containsFirst[MAXVERTICES];
+};
+
+//  Returns false if some vertex, other than the root lastElemOfPath, separates
+//  a part of the graph not containing firstElemOfPath from lastElemOfPath.
+static bool hasNoSeparatedPart(struct separationSearch *search, int vertex) {
+    search->discovered[vertex] = search->low[vertex] = ++search->time;
+    search->containsFirst[vertex] = vertex == search->firstElemOfPath;
+    forEach(neighbour, intersection(search->adjacencyList[vertex],
+     search->vertices)) {
+
+        //  The edge between the endpoints can only close the cycle.
+        if((vertex == search->firstElemOfPath &&
+         neighbour == search->lastElemOfPath) ||
+         (vertex == search->lastElemOfPath &&
+         neighbour == search->firstElemOfPath)) {
+            continue;
+        }
+        if(search->discovered[neighbour]) {
+            if(search->low[vertex] > search->discovered[neighbour]) {
+                search->low[vertex] = search->discovered[neighbour];
+            }
+            continue;
+        }
+        if(!hasNoSeparatedPart(search, neighbour)) {
+            return false;
+        }
+        if(search->low[vertex] > search->low[neighbour]) {
+            search->low[vertex] = search->low[neighbour];
+        }
+        search->containsFirst[vertex] |= search->containsFirst[neighbour];
+        if(vertex != search->lastElemOfPath && !search->containsFirst[neighbour]
+         && search->low[neighbour] >= search->discovered[vertex]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Returns false if the path cannot be extended to a hamiltonian cycle since
+//  the remaining vertices are disconnected or, if
+//  searchSettings.articulationCheck is set, since a remaining vertex
+//  separates a part of them from both endpoints. The remaining vertices
+//  should not be empty.
+static bool passesConnectivityCheck(bitset adjacencyList[], bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, int pathLength,
+enum searchEngine engine) {
+    int interval = searchSettings.connectivityCheckInterval[engine];
+    if(interval <= 0 || pathLength % interval != 0) {
+        return true;
+    }
+    struct connectivityStatistics *statistics =
+     &connectivityStatistics[engine];
+    atomic_fetch_add_explicit(&statistics->checks, 1, memory_order_relaxed);
+
+    //  The rest of the cycle is a hamiltonian path of the remaining vertices,
+    //  so these need to be connected.
+    if(!isConnectedSubgraph(adjacencyList, remainingVertices)) {
+        atomic_fetch_add_explicit(&statistics->disconnected, 1,
+         memory_order_relaxed);
+        return false;
+    }
+
+    if(!searchSettings.articulationCheck) {
+        return true;
+    }
+
+    //  Removing a vertex from a path leaves at most two parts, each
+    //  containing an endpoint.
+    struct separationSearch search = {.adjacencyList = adjacencyList,
+     .vertices = union(remainingVertices, union(singleton(firstElemOfPath),
+     singleton(lastElemOfPath))), .firstElemOfPath = firstElemOfPath,
+     .lastElemOfPath = lastElemOfPath};
+    forEach(vertex, search.vertices) {
+        search.discovered[vertex] = 0;
+    }
+    if(!hasNoSeparatedPart(&search, lastElemOfPath)) {
+        atomic_fetch_add_explicit(&statistics->separated, 1,
+         memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+struct transpositionStatistics transpositionStatistics;
+
+//  Paths with fewer remaining vertices are quicker to search again than to
+//  look up, so these are not stored in the transposition table.
+#define TRANSPOSITIONMINIMUM 8
+
+//  The number of entries among which an entry is replaced.
+#define TRANSPOSITIONBUCKETSIZE 4
+
+#define BITSETWORDS (sizeof(bitset) / sizeof(uint64_t))
+
+//  A path which could not be extended to a hamiltonian cycle. The key
+//  consists of the words of remainingVertices and a word containing the
+//  graph number and the endpoints. Writers make version odd while they
+//  change the key, so readers can detect that they read a torn key.
+struct transpositionEntry {
+    atomic_uint_fast64_t version;
+    _Atomic uint64_t key[BITSETWORDS + 1];
+};
+
+static struct transpositionEntry *transpositionTable;
+static uint64_t numberOfTranspositionBuckets;
+static pthread_once_t transpositionTableOnce = PTHREAD_ONCE_INIT;
+static atomic_ullong graphNumbers;
+
+unsigned long long int newGraphNumber(void) {
+    return atomic_fetch_add(&graphNumbers, 1) + 1;
+}
+
+//  Allocates the largest power of two buckets which fits in
+//  searchSettings.transpositionTableSize MiB.
+static void allocateTranspositionTable(void) {
+    size_t bytes = (size_t) searchSettings.transpositionTableSize << 20;
+    size_t bucketBytes = TRANSPOSITIONBUCKETSIZE *
+     sizeof(struct transpositionEntry);
+    numberOfTranspositionBuckets = 1;
+    while(2 * numberOfTranspositionBuckets * bucketBytes <= bytes) {
+        numberOfTranspositionBuckets *= 2;
+    }
+    transpositionTable = calloc(numberOfTranspositionBuckets *
+     TRANSPOSITIONBUCKETSIZE, sizeof(struct transpositionEntry));
+    if(transpositionTable == NULL) {
+        fprintf(stderr, "Error: Could not allocate transposition table.\n");
+        exit(1);
+    }
+}
+
+//  Fills key with the key of the path and returns the first entry of its
+//  bucket, or returns NULL if the path should not be looked up.
+static struct transpositionEntry *getTranspositionBucket(bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, int
+numberOfVertices, int pathLength, uint64_t key[]) {
+    if(searchSettings.transpositionTableSize <= 0 ||
+     searchControl.graphNumber == 0 ||
+     size(remainingVertices) < TRANSPOSITIONMINIMUM ||
+
+     //  The search only depends on the remaining vertices and the endpoints
+     //  if the path consists of the other vertices.
+     pathLength + size(remainingVertices) != numberOfVertices) {
+        return NULL;
+    }
+    pthread_once(&transpositionTableOnce, allocateTranspositionTable);
+    memcpy(key, &remainingVertices, sizeof(bitset));
+    key[BITSETWORDS] = searchControl.graphNumber << 16 |
+     (uint64_t) lastElemOfPath << 8 | (uint64_t) firstElemOfPath;
+    uint64_t hash = 0;
+    for(size_t i = 0; i <= BITSETWORDS; i++) {
+        hash = (hash ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    return &transpositionTable[(hash & (numberOfTranspositionBuckets - 1)) *
+     TRANSPOSITIONBUCKETSIZE];
+}
+
+static bool isRefutedPath(struct transpositionEntry *bucket, uint64_t key[]) {
+    for(int i = 0; i < TRANSPOSITIONBUCKETSIZE; i++) {
+        struct transpositionEntry *entry = &bucket[i];
+        uint64_t version = atomic_load_explicit(&entry->version,
+         memory_order_acquire);
+        if(version & 1) {
+            continue;
+        }
+        bool equal = true;
+        for(size_t j = 0; j <= BITSETWORDS; j++) {
+            equal &= atomic_load_explicit(&entry->key[j],
+             memory_order_relaxed) == key[j];
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if(equal && atomic_load_explicit(&entry->version,
+         memory_order_relaxed) == version) {
+            atomic_fetch_add_explicit(&transpositionStatistics.hits, 1,
+             memory_order_relaxed);
+            return true;
+        }
+    }
+    atomic_fetch_add_explicit(&transpositionStatistics.misses, 1,
+     memory_order_relaxed);
+    return false;
+}
+
+//  Replaces an empty entry, an entry of another graph or else the entry with
+//  the fewest remaining vertices, since it saves the least work. Gives up if
+//  another thread is writing that entry.
+static void storeRefutedPath(struct transpositionEntry *bucket, uint64_t
+key[]) {
+    struct transpositionEntry *victim = NULL;
+    int victimValue = MAXVERTICES + 2;
+    for(int i = 0; i < TRANSPOSITIONBUCKETSIZE; i++) {
+        struct transpositionEntry *entry = &bucket[i];
+        uint64_t graphAndEnds = atomic_load_explicit(&entry->key[BITSETWORDS],
+         memory_order_relaxed);
+        int value = 0;
+        if(graphAndEnds >> 16 == key[BITSETWORDS] >> 16) {
+            for(size_t j = 0; j < BITSETWORDS; j++) {
+                value += __builtin_popcountll(atomic_load_explicit(
+                 &entry->key[j], memory_order_relaxed));
+            }
+            value++;
+        }
+        if(value < victimValue) {
+            victim = entry;
+            victimValue = value;
+        }
+    }
+    uint64_t version = atomic_load_explicit(&victim->version,
+     memory_order_relaxed);
+    if((version & 1) || !atomic_compare_exchange_strong_explicit(
+     &victim->version, &version, version + 1, memory_order_relaxed,
+     memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    for(size_t j = 0; j <= BITSETWORDS; j++) {
+        atomic_store_explicit(&victim->key[j], key[j], memory_order_relaxed);
+    }
+    atomic_store_explicit(&victim->version, version + 2, memory_order_release);
+    atomic_fetch_add_explicit(&transpositionStatistics.stores, 1,
+     memory_order_relaxed);
+}
+
+//  When canBeHamiltonian returns true, foundPath[i] is the vertex at index i
+//  of the cycle it found, for every index from that of the last vertex of
+//  the path it was called with. The earlier vertices are known by the
+//  caller, the first of them is at index 0. If the search extended the path
+//  at its first vertex, the cycle continues from the last index backwards
+//  to this vertex.
+static __thread int foundPath[MAXVERTICES + 1];
+
+//  When canBeHamiltonianWithCounts returns true, foundExtension[i] is the
+//  vertex with which the path of length i was extended towards the cycle,
+//  and foundEnd[i] the end of that path to which it was joined.
+static __thread int foundExtension[MAXVERTICES + 1];
+static __thread int foundEnd[MAXVERTICES + 1];
+
+//  The search of canBeHamiltonian, where counts are the option counts of the
+//  path and hasOptions is whether it passes remainingVerticesHaveOptions.
+//  If counts is NULL, the search calls remainingVerticesHaveOptions itself
+//  and hasOptions is ignored. isBranch is false if the path was the only
+//  extension of its parent, which is then not counted as a node.
+static bool canBeHamiltonianWithCounts(struct optionCounts *counts, bool
+hasOptions, bool isBranch, bitset adjacencyList[], bitset remainingVertices,
+int lastElemOfPath, int firstElemOfPath, int numberOfVertices, int
+pathLength) {
+
+    //  Some other search already settled the answer or the budget is
+    //  exceeded.
+    if(searchStopped()) {
+        return false;
+    }
+    if(isBranch) {
+        countSearchNode();
+        countPruneEvent(SEARCH_NODE, pathLength);
+    }
 
     // Check whether we have a Hamiltonian path already and whether this path
     // is a cycle.
     if((pathLength == numberOfVertices) && contains(adjacencyList[firstElemOfPath], lastElemOfPath)) {
+        countPruneEvent(CYCLE_FOUND, pathLength);
         return true;
     }
 
     // Check if cycle can still be closed with remaining vertices.
     if(isEmpty(intersection(adjacencyList[firstElemOfPath],remainingVertices))) { 
+        countPruneEvent(NOT_CLOSABLE, pathLength);
         return false;
     }
 
     // Check for all elements not yet visited whether they still have two
     // neighbours to which they can connect.
-    bitset remainingWithFirstAndLast = 
-     union(remainingVertices, union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
-    forEach(vertex, remainingVertices) {
+    if(counts == NULL) {
+        hasOptions = remainingVerticesHaveOptions(adjacencyList,
+         remainingVertices, lastElemOfPath, firstElemOfPath);
+    }
+    if(!hasOptions) {
+        countPruneEvent(TOO_FEW_OPTIONS, pathLength);
+        return false;
+    }
+
+    //  Skip paths which were already found not to extend to a cycle.
+    uint64_t key[BITSETWORDS + 1] = {0};
+    struct transpositionEntry *bucket = getTranspositionBucket(
+     remainingVertices, lastElemOfPath, firstElemOfPath, numberOfVertices,
+     pathLength, key);
+    if(bucket != NULL && isRefutedPath(bucket, key)) {
+        countPruneEvent(REFUTED_PATH, pathLength);
+        return false;
+    }
 
-        //  Neighbours which either do not lie in the path, or which are one
-        //  of its endpoints.
-        bitset remainingNeighbours = 
-         intersection(adjacencyList[vertex], remainingWithFirstAndLast );
+    if(!passesConnectivityCheck(adjacencyList, remainingVertices,
+     lastElemOfPath, firstElemOfPath, pathLength, CYCLE_SEARCH)) {
+        countPruneEvent(CONNECTIVITY_CUT, pathLength);
+        return false;
+    }
 
-        //  If there is only one such neighbour or less, our path cannot be
-        //  extended through this vertex into a hamiltonian cycle.
-        if(size(remainingNeighbours) < 2) return false;
+    //  The cycle has to leave both ends of the path, so the search may as
+    //  well extend the path at the end with the fewest ways to do so. Since
+    //  the cycle is undirected, this only means swapping the ends.
+    if(searchSettings.bidirectionalExtension && size(intersection(
+     adjacencyList[firstElemOfPath], remainingVertices)) < size(intersection(
+     adjacencyList[lastElemOfPath], remainingVertices))) {
+        int swap = firstElemOfPath;
+        firstElemOfPath = lastElemOfPath;
+        lastElemOfPath = swap;
     }
 
     // Create a bitset of the neighbours of the last element in the path which
@@ -47,6 +832,18 @@ lastElemOfPath, int firstElemOfPath, int numberOfVertices, int pathLength) {
     // neighbours.
     bitset neighboursOfLastNotInPath = 
      intersection(adjacencyList[lastElemOfPath], remainingVertices);
+
+    //  Only keep the extensions which are not ruled out by forced edges.
+    if(searchSettings.forcedEdgePropagation && pathLength > 1 &&
+     !determineForcedEdges(adjacencyList, remainingVertices, lastElemOfPath,
+     firstElemOfPath, &neighboursOfLastNotInPath)) {
+        countPruneEvent(FORCED_EDGE_CONFLICT, pathLength);
+        return false;
+    }
+
+    //  If only one extension is left, it is forced and not a branch.
+    bool isForced = searchSettings.bidirectionalExtension &&
+     size(neighboursOfLastNotInPath) == 1;
     forEach(neighbour, neighboursOfLastNotInPath) {
 
         //  Save the current last element of path. If an extension cannot be a
@@ -58,34 +855,89 @@ lastElemOfPath, int firstElemOfPath, int numberOfVertices, int pathLength) {
         //  that does no belong to the path yet.
         removeElement(remainingVertices, neighbour);
         lastElemOfPath = neighbour; // Neighbour is the new last element.
+        bool extensionHasOptions = counts == NULL || extendOptionCounts(counts,
+         adjacencyList, remainingVertices, oldElemOfPath, lastElemOfPath,
+         firstElemOfPath);
 
         //  If this extension can become a hamiltonian cycle, so can the
         //  current path.
-        if (canBeHamiltonian(adjacencyList, remainingVertices, lastElemOfPath,
+        if (canBeHamiltonianWithCounts(counts, extensionHasOptions,
+         !isForced, adjacencyList, remainingVertices, lastElemOfPath,
          firstElemOfPath, numberOfVertices, pathLength + 1)) {
+            foundExtension[pathLength] = neighbour;
+            foundEnd[pathLength] = oldElemOfPath;
             return true;
         }
 
         //  If we reach this part, the extension could not become a
         //  hamiltonian cycle, hence we need to look again at the other
         //  possible extensions for our old path.
+        if(counts != NULL) {
+            retractOptionCounts(counts, adjacencyList, remainingVertices,
+             oldElemOfPath, lastElemOfPath, firstElemOfPath);
+        }
         add(remainingVertices, lastElemOfPath);
         lastElemOfPath = oldElemOfPath;
     }
 
+    //  A cancelled search did not look at all extensions.
+    if(bucket != NULL && !searchStopped()) {
+        storeRefutedPath(bucket, key);
+    }
+    countPruneEvent(EXTENSIONS_EXHAUSTED, pathLength);
+
     //  None of the possible extensions worked, so the path cannot be a
     //  hamiltonian cycle.
     return false;
 }
 
+bool canBeHamiltonian(bitset adjacencyList[], bitset remainingVertices, int
+lastElemOfPath, int firstElemOfPath, int numberOfVertices, int pathLength) {
+    struct optionCounts counts;
+    bool useCounts = useOptionCounts(adjacencyList, remainingVertices,
+     lastElemOfPath, firstElemOfPath);
+    bool hasOptions = useCounts && countOptions(&counts, adjacencyList,
+     remainingVertices, lastElemOfPath, firstElemOfPath);
+    if(!canBeHamiltonianWithCounts(useCounts ? &counts : NULL, hasOptions,
+     true, adjacencyList, remainingVertices, lastElemOfPath, firstElemOfPath,
+     numberOfVertices, pathLength)) {
+        return false;
+    }
+
+    //  Lay out the extensions along the cycle, the ones at the last vertex
+    //  after it and the ones at the first vertex before index 0.
+    int lastIndex = pathLength - 1;
+    int firstIndex = numberOfVertices;
+    foundPath[lastIndex] = lastElemOfPath;
+    for(int length = pathLength; length < numberOfVertices; length++) {
+        if(foundEnd[length] == lastElemOfPath) {
+            lastElemOfPath = foundExtension[length];
+            foundPath[++lastIndex] = lastElemOfPath;
+        }
+        else {
+            foundPath[--firstIndex] = foundExtension[length];
+        }
+    }
+    return true;
+}
+
+//  The search of canBeHamiltonianPrintCycle, see
+//  canBeHamiltonianWithCounts.
+static bool canBeHamiltonianPrintCycleWithCounts(struct optionCounts *counts,
+bool hasOptions, bitset adjacencyList[], bitset remainingVertices, int
+pathList[], int lastElemOfPath, int firstElemOfPath, int numberOfVertices,
+int pathLength, int* numberOfHamiltonianCycles, bool allCyclesFlag, bool
+verboseFlag) {
 
-bool canBeHamiltonianPrintCycle(bitset adjacencyList[], bitset
-remainingVertices, int pathList[], int lastElemOfPath, int firstElemOfPath,
-int numberOfVertices, int pathLength, int* numberOfHamiltonianCycles, bool
-allCyclesFlag, bool verboseFlag) {
+    if(isExceeded(searchControl.budget)) {
+        return false;
+    }
+    countSearchNode();
+    countPruneEvent(SEARCH_NODE, pathLength);
 
     // Check whether we have a Hamiltonian path already and whether this path is a cycle.
     if((pathLength == numberOfVertices) && contains(adjacencyList[firstElemOfPath], lastElemOfPath)) {
+        countPruneEvent(CYCLE_FOUND, pathLength);
         if(verboseFlag) {
             fprintf(stderr,"Path: ");
             for(int i = 1; i < numberOfVertices; i++) {
@@ -99,23 +951,25 @@ allCyclesFlag, bool verboseFlag) {
 
     // Check if cycle can still be closed with remaining vertices.
     if(isEmpty(intersection(adjacencyList[firstElemOfPath],remainingVertices))) { 
+        countPruneEvent(NOT_CLOSABLE, pathLength);
         return false;
     }
 
     // Check for all elements not yet visited whether they still have two
     // neighbours to which they can connect.
-    bitset remainingWithFirstAndLast = 
-     union(remainingVertices, union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
-    forEach(vertex, remainingVertices) {
-
-        //  Neighbours which either do not lie in the path, or which are one
-        //  of its endpoints.
-        bitset remainingNeighbours = 
-         intersection(adjacencyList[vertex], remainingWithFirstAndLast );
+    if(counts == NULL) {
+        hasOptions = remainingVerticesHaveOptions(adjacencyList,
+         remainingVertices, lastElemOfPath, firstElemOfPath);
+    }
+    if(!hasOptions) {
+        countPruneEvent(TOO_FEW_OPTIONS, pathLength);
+        return false;
+    }
 
-        //  If there is only one such neighbour or less, our path cannot be
-        //  extended through this vertex into a hamiltonian cycle.
-        if(size(remainingNeighbours) < 2) return false;
+    if(!passesConnectivityCheck(adjacencyList, remainingVertices,
+     lastElemOfPath, firstElemOfPath, pathLength, PRINT_CYCLE_SEARCH)) {
+        countPruneEvent(CONNECTIVITY_CUT, pathLength);
+        return false;
     }
 
     // Create a bitset of the neighbours of the last element in the path which
@@ -123,6 +977,14 @@ allCyclesFlag, bool verboseFlag) {
     // neighbours.
     bitset neighboursOfLastNotInPath = 
      intersection(adjacencyList[lastElemOfPath], remainingVertices);
+
+    //  Only keep the extensions which are not ruled out by forced edges.
+    if(searchSettings.forcedEdgePropagation && pathLength > 1 &&
+     !determineForcedEdges(adjacencyList, remainingVertices, lastElemOfPath,
+     firstElemOfPath, &neighboursOfLastNotInPath)) {
+        countPruneEvent(FORCED_EDGE_CONFLICT, pathLength);
+        return false;
+    }
     forEach(neighbour, neighboursOfLastNotInPath) {
 
         //  Save the current last element of path. If an extension cannot be a
@@ -135,13 +997,16 @@ allCyclesFlag, bool verboseFlag) {
         removeElement(remainingVertices, neighbour);
         lastElemOfPath = neighbour; // Neighbour is the new last element.
         pathList[pathLength] = neighbour;
+        bool extensionHasOptions = counts == NULL || extendOptionCounts(counts,
+         adjacencyList, remainingVertices, oldElemOfPath, lastElemOfPath,
+         firstElemOfPath);
 
         //  If this extension can become a hamiltonian cycle, so can the
         //  current path.
-        if (canBeHamiltonianPrintCycle(adjacencyList, remainingVertices, 
-         pathList, lastElemOfPath, firstElemOfPath, numberOfVertices,
-         pathLength + 1, numberOfHamiltonianCycles, allCyclesFlag,
-         verboseFlag)) {
+        if (canBeHamiltonianPrintCycleWithCounts(counts, extensionHasOptions,
+         adjacencyList, remainingVertices, pathList, lastElemOfPath,
+         firstElemOfPath, numberOfVertices, pathLength + 1,
+         numberOfHamiltonianCycles, allCyclesFlag, verboseFlag)) {
 
             // In the case we want to find all cycles, we should only
             // backtrack once we have exhausted all possibilities.
@@ -152,32 +1017,1049 @@ allCyclesFlag, bool verboseFlag) {
         //  If we reach this part, the extension could not become a
         //  hamiltonian cycle, hence we need to look again at the other
         //  possible extensions for our old path.
+        if(counts != NULL) {
+            retractOptionCounts(counts, adjacencyList, remainingVertices,
+             oldElemOfPath, lastElemOfPath, firstElemOfPath);
+        }
         add(remainingVertices, lastElemOfPath);
         lastElemOfPath = oldElemOfPath;
     }
 
     //  None of the possible extensions worked, so the path cannot be a
     //  hamiltonian cycle.
+    countPruneEvent(EXTENSIONS_EXHAUSTED, pathLength);
     return (*numberOfHamiltonianCycles);
 }
 
-bool isHamiltonian(bitset adjacencyList[], int numberOfVertices, bitset
-excludedVertices, bool allCyclesFlag, bool verboseFlag) { 
-    int numberOfHamiltonianCycles = 0;
+bool canBeHamiltonianPrintCycle(bitset adjacencyList[], bitset
+remainingVertices, int pathList[], int lastElemOfPath, int firstElemOfPath,
+int numberOfVertices, int pathLength, int* numberOfHamiltonianCycles, bool
+allCyclesFlag, bool verboseFlag) {
+    struct optionCounts counts;
+    bool useCounts = useOptionCounts(adjacencyList, remainingVertices,
+     lastElemOfPath, firstElemOfPath);
+    bool hasOptions = useCounts && countOptions(&counts, adjacencyList,
+     remainingVertices, lastElemOfPath, firstElemOfPath);
+    return canBeHamiltonianPrintCycleWithCounts(useCounts ? &counts : NULL,
+     hasOptions, adjacencyList, remainingVertices, pathList, lastElemOfPath,
+     firstElemOfPath, numberOfVertices, pathLength, numberOfHamiltonianCycles,
+     allCyclesFlag, verboseFlag);
+}
 
-    //  We check whether the subgraph spanned by the included vertices is
-    //  hamiltonian.
-    bitset includedVertices = complement(excludedVertices, numberOfVertices);
+//  A path which still has to be extended to a hamiltonian cycle. These are
+//  the tasks of the parallel search.
+struct pathState {
+    bitset remainingVertices;
+    int lastElemOfPath;
+    int firstElemOfPath;
+    int pathLength;
+};
 
-    if(isEmpty(includedVertices)) return false;
+//  Paths which are at most this many vertices longer than the path at the
+//  root of the search get split into their extensions instead of being
+//  searched by a single thread.
+#define SPLITDEPTH 10
+
+//  The owner of a deque pushes and pops paths at the bottom, so it explores
+//  its part of the tree depth-first. Idle workers steal from the top, where
+//  the shortest paths and thus the largest subtrees are.
+struct pathDeque {
+    pthread_mutex_t mutex;
+    struct pathState *states;
+    int top;
+    int bottom;
+    int capacity;
+};
 
-    // First included vertex.
-    int startingVertex = next(includedVertices,-1);
-    int lowestDegree = size(adjacencyList[startingVertex]);
+struct parallelSearch {
+    bitset *adjacencyList;
+    int numberOfVertices;
+    int rootPathLength;
+    int numberOfWorkers;
+    struct pathDeque *deques;
+
+    //  Paths which were pushed on some deque, but of which the search has not
+    //  finished yet. The search is over once this reaches zero.
+    atomic_int unfinishedPaths;
+
+    //  Idle workers wait for workChanged, which is signalled with
+    //  workVersion increased when paths are pushed, the last path is
+    //  finished or the search is stopped.
+    pthread_mutex_t idleMutex;
+    pthread_cond_t workChanged;
+    atomic_ullong workVersion;
+
+    //  Set as soon as a hamiltonian cycle is found or the search which
+    //  started this one got cancelled.
+    atomic_bool stopped;
+    atomic_bool foundCycle;
+    atomic_bool *parentCancelled;
+    unsigned long long int graphNumber;
+    struct searchBudget *budget;
+    struct searchCost *cost;
+
+    //  The search nodes visited by all workers.
+    atomic_llong nodes;
+};
 
-    //  Find an included vertex of lowest degree.
-    forEachAfterIndex(includedVertex, includedVertices, startingVertex){
-        int degreeOfNeighbour = 
+static void pushPath(struct pathDeque *deque, struct pathState *state) {
+    pthread_mutex_lock(&deque->mutex);
+    if(deque->bottom == deque->capacity) {
+        deque->capacity = 2 * deque->capacity + 16;
+        deque->states = realloc(deque->states, deque->capacity *
+         sizeof(struct pathState));
+        if(deque->states == NULL) {
+            fprintf(stderr, "Error: Out of memory.\n");
+            exit(1);
+        }
+    }
+    deque->states[deque->bottom++] = *state;
+    pthread_mutex_unlock(&deque->mutex);
+}
+
+//  Wakes up the idle workers of the search.
+static void announceWork(struct parallelSearch *search) {
+    pthread_mutex_lock(&search->idleMutex);
+    atomic_fetch_add(&search->workVersion, 1);
+    pthread_cond_broadcast(&search->workChanged);
+    pthread_mutex_unlock(&search->idleMutex);
+}
+
+static bool popPath(struct pathDeque *deque, struct pathState *state, bool
+fromTop) {
+    bool popped = false;
+    pthread_mutex_lock(&deque->mutex);
+    if(deque->top < deque->bottom) {
+        *state = fromTop ? deque->states[deque->top++] :
+         deque->states[--deque->bottom];
+        if(deque->top == deque->bottom) {
+            deque->top = deque->bottom = 0;
+        }
+        popped = true;
+    }
+    pthread_mutex_unlock(&deque->mutex);
+    return popped;
+}
+
+//  Performs the same checks as canBeHamiltonian on the path. Returns false if
+//  the path cannot be extended to a hamiltonian cycle. Otherwise, if the path
+//  is short enough to be split, pushes its extensions on deque and returns
+//  false, or searches it entirely and returns the result.
+static bool processPath(struct parallelSearch *search, struct pathDeque
+*deque, struct pathState *state) {
+    bitset *adjacencyList = search->adjacencyList;
+    int numberOfVertices = search->numberOfVertices;
+    if(state->pathLength - search->rootPathLength >= SPLITDEPTH ||
+     numberOfVertices - state->pathLength <= SPLITDEPTH) {
+        return canBeHamiltonian(adjacencyList, state->remainingVertices,
+         state->lastElemOfPath, state->firstElemOfPath, numberOfVertices,
+         state->pathLength);
+    }
+
+    countPruneEvent(SEARCH_NODE, state->pathLength);
+    if((state->pathLength == numberOfVertices) &&
+     contains(adjacencyList[state->firstElemOfPath], state->lastElemOfPath)) {
+        countPruneEvent(CYCLE_FOUND, state->pathLength);
+        return true;
+    }
+    if(isEmpty(intersection(adjacencyList[state->firstElemOfPath],
+     state->remainingVertices))) { 
+        countPruneEvent(NOT_CLOSABLE, state->pathLength);
+        return false;
+    }
+    if(!remainingVerticesHaveOptions(adjacencyList, state->remainingVertices,
+     state->lastElemOfPath, state->firstElemOfPath)) {
+        countPruneEvent(TOO_FEW_OPTIONS, state->pathLength);
+        return false;
+    }
+
+    //  Pushed in reverse order, so that the owner pops the extensions in the
+    //  same order as canBeHamiltonian would try them.
+    bitset neighboursOfLastNotInPath =
+     intersection(adjacencyList[state->lastElemOfPath],
+     state->remainingVertices);
+    if(searchSettings.forcedEdgePropagation && state->pathLength > 1 &&
+     !determineForcedEdges(adjacencyList, state->remainingVertices,
+     state->lastElemOfPath, state->firstElemOfPath,
+     &neighboursOfLastNotInPath)) {
+        countPruneEvent(FORCED_EDGE_CONFLICT, state->pathLength);
+        return false;
+    }
+    int neighbours[MAXVERTICES];
+    int numberOfNeighbours = 0;
+    forEach(neighbour, neighboursOfLastNotInPath) {
+        neighbours[numberOfNeighbours++] = neighbour;
+    }
+    atomic_fetch_add(&search->unfinishedPaths, numberOfNeighbours);
+    for(int i = numberOfNeighbours - 1; i >= 0; i--) {
+        struct pathState extension = *state;
+        removeElement(extension.remainingVertices, neighbours[i]);
+        extension.lastElemOfPath = neighbours[i];
+        extension.pathLength++;
+        pushPath(deque, &extension);
+    }
+    if(numberOfNeighbours > 0) {
+        announceWork(search);
+    }
+    return false;
+}
+
+static void searchPaths(void *argument, int worker) {
+    struct parallelSearch *search = argument;
+    struct pathDeque *ownDeque = &search->deques[worker];
+    struct searchControl oldControl = searchControl;
+    searchControl.cancelled = &search->stopped;
+    searchControl.parentCancelled = search->parentCancelled;
+    searchControl.graphNumber = search->graphNumber;
+    setSearchBudget(search->budget);
+    searchControl.cost = search->cost;
+    long long int nodes = searchNodesOfThread();
+
+    while(!atomic_load_explicit(&search->stopped, memory_order_relaxed)) {
+        if(isCancelled(search->parentCancelled) ||
+         isExceeded(search->budget)) {
+            atomic_store(&search->stopped, true);
+            announceWork(search);
+            break;
+        }
+
+        //  Take a path from the own deque, or else steal one from the others.
+        unsigned long long int version = atomic_load(&search->workVersion);
+        struct pathState state;
+        bool found = popPath(ownDeque, &state, false);
+        for(int i = 1; !found && i < search->numberOfWorkers; i++) {
+            found = popPath(&search->deques[(worker + i) %
+             search->numberOfWorkers], &state, true);
+        }
+
+        //  Without a path, wait until another worker pushes paths or the
+        //  search is over. Some worker is still searching a path then, which
+        //  notices when the search which started this one gets cancelled.
+        if(!found) {
+            pthread_mutex_lock(&search->idleMutex);
+            while(atomic_load(&search->workVersion) == version &&
+             atomic_load(&search->unfinishedPaths) > 0 &&
+             !atomic_load(&search->stopped)) {
+                pthread_cond_wait(&search->workChanged, &search->idleMutex);
+            }
+            bool finished = atomic_load(&search->unfinishedPaths) == 0;
+            pthread_mutex_unlock(&search->idleMutex);
+            if(finished) {
+                break;
+            }
+            continue;
+        }
+
+        bool foundCycle = processPath(search, ownDeque, &state);
+        if(foundCycle) {
+            atomic_store(&search->foundCycle, true);
+            atomic_store(&search->stopped, true);
+        }
+        if(atomic_fetch_sub(&search->unfinishedPaths, 1) == 1 || foundCycle) {
+            announceWork(search);
+        }
+    }
+    flushSearchNodes();
+    searchControl = oldControl;
+    moveNodesToSearch(nodes, &search->nodes);
+}
+
+//  Returns whether one of the given paths can be extended to a hamiltonian
+//  cycle. The search trees of these paths get split up and divided over
+//  searchSettings.searchThreads threads, which steal work from each other.
+static bool canBeHamiltonianForSomePath(bitset adjacencyList[], int
+numberOfVertices, struct pathState paths[], int numberOfPaths) {
+    int numberOfWorkers = searchSettings.searchThreads;
+    struct pathDeque deques[numberOfWorkers];
+    struct parallelSearch search = {.adjacencyList = adjacencyList,
+     .numberOfVertices = numberOfVertices, .rootPathLength =
+     paths[0].pathLength, .numberOfWorkers = numberOfWorkers, .deques = deques,
+     .parentCancelled = searchControl.cancelled, .graphNumber =
+     searchControl.graphNumber, .budget = searchControl.budget, .cost =
+     searchControl.cost};
+    atomic_init(&search.nodes, 0);
+    for(int i = 0; i < numberOfWorkers; i++) {
+        deques[i] = (struct pathDeque) {.states = NULL};
+        pthread_mutex_init(&deques[i].mutex, NULL);
+    }
+    atomic_init(&search.unfinishedPaths, numberOfPaths);
+    atomic_init(&search.stopped, false);
+    atomic_init(&search.foundCycle, false);
+    pthread_mutex_init(&search.idleMutex, NULL);
+    pthread_cond_init(&search.workChanged, NULL);
+    atomic_init(&search.workVersion, 0);
+
+    //  In reverse order, so that the first path is searched first.
+    for(int i = numberOfPaths - 1; i >= 0; i--) {
+        pushPath(&deques[0], &paths[i]);
+    }
+    runTasks(numberOfWorkers, numberOfWorkers, searchPaths, &search);
+    countedNodes += atomic_load(&search.nodes);
+
+    for(int i = 0; i < numberOfWorkers; i++) {
+        pthread_mutex_destroy(&deques[i].mutex);
+        free(deques[i].states);
+    }
+    pthread_mutex_destroy(&search.idleMutex);
+    pthread_cond_destroy(&search.workChanged);
+    return atomic_load(&search.foundCycle);
+}
+
+bool canBeHamiltonianInParallel(bitset adjacencyList[], bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, int
+numberOfVertices, int pathLength) {
+    if(searchSettings.searchThreads <= 1) {
+        return canBeHamiltonian(adjacencyList, remainingVertices,
+         lastElemOfPath, firstElemOfPath, numberOfVertices, pathLength);
+    }
+    struct pathState path = {.remainingVertices = remainingVertices,
+     .lastElemOfPath = lastElemOfPath, .firstElemOfPath = firstElemOfPath,
+     .pathLength = pathLength};
+    return canBeHamiltonianForSomePath(adjacencyList, numberOfVertices, &path,
+     1);
+}
+
+//  Tables of the Held-Karp dynamic programming engine which are kept per
+//  thread. A table is reused as long as the same graph is checked, so all
+//  vertex-deleted and edge-deleted subgraphs of a graph share it.
+#define HELDKARPTABLES 3
+
+//  For the start vertex of the table and every set of vertices containing
+//  it, reachableEnds contains the vertices in which a hamiltonian path of the
+//  subgraph spanned by the set starting in the start vertex can end. The
+//  sets are indexed without the bit of the start vertex.
+struct heldKarpTable {
+    uint32_t *reachableEnds;
+    int startVertex;
+    int numberOfVertices;
+    uint32_t adjacencyList[32];
+    unsigned long long int lastUse;
+};
+
+static __thread struct heldKarpTable heldKarpTables[HELDKARPTABLES];
+static __thread unsigned long long int heldKarpUses;
+
+static uint32_t toMask(bitset vertices) {
+    uint32_t mask = 0;
+    forEach(vertex, vertices) {
+        mask |= (uint32_t) 1 << vertex;
+    }
+    return mask;
+}
+
+//  Index of a set containing the start vertex in reachableEnds.
+static uint32_t heldKarpIndex(uint32_t mask, int startVertex) {
+    uint32_t below = ((uint32_t) 1 << startVertex) - 1;
+    return (mask & below) | ((mask >> (startVertex + 1)) << startVertex);
+}
+
+//  The number of sets the Held-Karp engine handles between two checks
+//  whether the search was stopped.
+#define HELDKARPCHECKINTERVAL 4096
+
+//  Returns a table for the graph and start vertex, filling a new one if none
+//  of the tables of this thread was computed for it. Returns NULL if the
+//  search was stopped while filling it.
+static struct heldKarpTable *getHeldKarpTable(bitset adjacencyList[], int
+numberOfVertices, int startVertex) {
+    uint32_t adjacencyMasks[numberOfVertices];
+    for(int i = 0; i < numberOfVertices; i++) {
+        adjacencyMasks[i] = toMask(adjacencyList[i]);
+    }
+
+    struct heldKarpTable *table = &heldKarpTables[0];
+    for(int i = 0; i < HELDKARPTABLES; i++) {
+        struct heldKarpTable *candidate = &heldKarpTables[i];
+        if(candidate->reachableEnds != NULL &&
+         candidate->startVertex == startVertex &&
+         candidate->numberOfVertices == numberOfVertices &&
+         !memcmp(candidate->adjacencyList, adjacencyMasks,
+         sizeof(adjacencyMasks))) {
+            candidate->lastUse = ++heldKarpUses;
+            return candidate;
+        }
+        if(candidate->lastUse < table->lastUse) {
+            table = candidate;
+        }
+    }
+
+    //  Replace the least recently used table.
+    if(table->reachableEnds == NULL ||
+     table->numberOfVertices != numberOfVertices) {
+        free(table->reachableEnds);
+        table->reachableEnds = malloc(((size_t) 1 << (numberOfVertices - 1))
+         * sizeof(uint32_t));
+        if(table->reachableEnds == NULL) {
+            fprintf(stderr, "Error: Could not allocate Held-Karp table.\n");
+            exit(1);
+        }
+    }
+    table->startVertex = startVertex;
+    table->numberOfVertices = numberOfVertices;
+    memcpy(table->adjacencyList, adjacencyMasks, sizeof(adjacencyMasks));
+    table->lastUse = ++heldKarpUses;
+
+    //  A set without the vertex v precedes the set with v, so the ends
+    //  of all smaller paths are known when a set is handled.
+    uint32_t startBit = (uint32_t) 1 << startVertex;
+    uint32_t below = startBit - 1;
+    uint32_t numberOfSets = (uint32_t) 1 << (numberOfVertices - 1);
+    table->reachableEnds[0] = startBit;
+    for(uint32_t index = 1; index < numberOfSets; index++) {
+        if(index % HELDKARPCHECKINTERVAL == 0 && searchStoppedOrLate()) {
+
+            //  Make sure that the partial table is never used.
+            table->startVertex = -1;
+            table->numberOfVertices = 0;
+            table->lastUse = 0;
+            return NULL;
+        }
+        uint32_t mask = (index & below) | ((index & ~below) << 1) | startBit;
+        uint32_t ends = 0;
+        for(uint32_t others = mask & ~startBit; others; others &= others - 1) {
+            int end = __builtin_ctz(others);
+            uint32_t withoutEnd = mask & ~((uint32_t) 1 << end);
+            if(adjacencyMasks[end] &
+             table->reachableEnds[heldKarpIndex(withoutEnd, startVertex)]) {
+                ends |= (uint32_t) 1 << end;
+            }
+        }
+        table->reachableEnds[index] = ends;
+    }
+    return table;
+}
+
+//  Returns whether the subgraph spanned by includedVertices is hamiltonian
+//  using the Held-Karp tables.
+static bool isHamiltonianHeldKarp(bitset adjacencyList[], int
+numberOfVertices, bitset includedVertices) {
+    if(size(includedVertices) < 3) {
+        return false;
+    }
+    int startVertex = next(includedVertices, -1);
+    struct heldKarpTable *table = getHeldKarpTable(adjacencyList,
+     numberOfVertices, startVertex);
+    if(table == NULL) {
+        return false;
+    }
+    uint32_t mask = toMask(includedVertices);
+    return table->reachableEnds[heldKarpIndex(mask, startVertex)] &
+     table->adjacencyList[startVertex];
+}
+
+//  Returns whether the subgraph spanned by includedVertices contains a
+//  hamiltonian path between start and end using the Held-Karp tables.
+static bool containsHamiltonianPathHeldKarp(bitset adjacencyList[], int
+numberOfVertices, bitset includedVertices, int start, int end) {
+
+    //  Prefer the start vertex of a table which is already there.
+    if(start > end) {
+        int temp = start;
+        start = end;
+        end = temp;
+    }
+    for(int i = 0; i < HELDKARPTABLES; i++) {
+        if(heldKarpTables[i].reachableEnds != NULL &&
+         heldKarpTables[i].startVertex == end) {
+            end = start;
+            start = heldKarpTables[i].startVertex;
+            break;
+        }
+    }
+    struct heldKarpTable *table = getHeldKarpTable(adjacencyList,
+     numberOfVertices, start);
+    if(table == NULL) {
+        return false;
+    }
+    uint32_t mask = toMask(includedVertices);
+    return table->reachableEnds[heldKarpIndex(mask, start)] &
+     ((uint32_t) 1 << end);
+}
+
+//  Whether the Held-Karp engine should be used for a graph of this order.
+static bool useHeldKarp(int numberOfVertices) {
+    return numberOfVertices >= 2 &&
+     numberOfVertices <= searchSettings.heldKarpMaxOrder &&
+     numberOfVertices <= HELDKARPMAXORDER;
+}
+
+struct meetInTheMiddleStatistics meetInTheMiddleStatistics;
+
+//  A path grown from one of the ends of the hamiltonian path which is
+//  searched, given by its vertices and the vertex in which it ends. Paths
+//  from the end are stored with MAXVERTICES added to their vertex, so that
+//  they do not meet the paths from the start. An entry only belongs to the
+//  current query if it has the generation of the table.
+struct halfPath {
+    bitset vertices;
+    int end;
+    uint32_t generation;
+};
+
+//  An open addressing hash table of half paths kept per thread, which grows
+//  up to searchSettings.meetInTheMiddleMemory MiB.
+struct halfPathTable {
+    struct halfPath *entries;
+    uint64_t capacity;
+    uint64_t numberOfEntries;
+    uint32_t generation;
+};
+
+static __thread struct halfPathTable halfPaths;
+
+//  Empties the table for a new query.
+static void startHalfPathQuery(void) {
+    halfPaths.numberOfEntries = 0;
+    if(++halfPaths.generation == 0 && halfPaths.entries != NULL) {
+        memset(halfPaths.entries, 0, halfPaths.capacity *
+         sizeof(struct halfPath));
+        halfPaths.generation = 1;
+    }
+}
+
+static struct halfPath *findHalfPath(struct halfPath *entries, uint64_t
+capacity, uint32_t generation, bitset vertices, int end) {
+    uint64_t key[BITSETWORDS + 1];
+    memcpy(key, &vertices, sizeof(bitset));
+    key[BITSETWORDS] = end;
+    uint64_t hash = 0;
+    for(size_t i = 0; i <= BITSETWORDS; i++) {
+        hash = (hash ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    for(uint64_t slot = hash & (capacity - 1);; slot = (slot + 1) &
+     (capacity - 1)) {
+        struct halfPath *entry = &entries[slot];
+        if(entry->generation != generation || (entry->end == end &&
+         equals(entry->vertices, vertices))) {
+            return entry;
+        }
+    }
+}
+
+//  Doubles the capacity of the table, or returns false if this would exceed
+//  the memory it may take.
+static bool growHalfPathTable(void) {
+    uint64_t capacity = halfPaths.entries == NULL ? 1024 :
+     2 * halfPaths.capacity;
+    if(capacity * sizeof(struct halfPath) >
+     ((uint64_t) searchSettings.meetInTheMiddleMemory << 20)) {
+        return false;
+    }
+    struct halfPath *entries = calloc(capacity, sizeof(struct halfPath));
+    if(entries == NULL) {
+        fprintf(stderr, "Error: Could not allocate meet-in-the-middle table.\n");
+        exit(1);
+    }
+    for(uint64_t i = 0; halfPaths.entries != NULL && i < halfPaths.capacity;
+     i++) {
+        struct halfPath *entry = &halfPaths.entries[i];
+        if(entry->generation == halfPaths.generation) {
+            *findHalfPath(entries, capacity, 1, entry->vertices, entry->end) =
+             (struct halfPath) {.vertices = entry->vertices, .end =
+             entry->end, .generation = 1};
+        }
+    }
+    free(halfPaths.entries);
+    halfPaths.entries = entries;
+    halfPaths.capacity = capacity;
+    halfPaths.generation = 1;
+    return true;
+}
+
+//  Returns whether the half path was already in the table and adds it if
+//  not. Sets exceeded if the table is full.
+static bool containsHalfPath(bitset vertices, int end, bool *exceeded) {
+    if(2 * (halfPaths.numberOfEntries + 1) > halfPaths.capacity &&
+     !growHalfPathTable()) {
+        *exceeded = true;
+        return true;
+    }
+    struct halfPath *entry = findHalfPath(halfPaths.entries,
+     halfPaths.capacity, halfPaths.generation, vertices, end);
+    if(entry->generation == halfPaths.generation) {
+        return true;
+    }
+    *entry = (struct halfPath) {.vertices = vertices, .end = end,
+     .generation = halfPaths.generation};
+    halfPaths.numberOfEntries++;
+    return false;
+}
+
+//  Whether the table contains a half path, without adding it.
+static bool hasHalfPath(bitset vertices, int end) {
+    return findHalfPath(halfPaths.entries, halfPaths.capacity,
+     halfPaths.generation, vertices, end)->generation ==
+     halfPaths.generation;
+}
+
+//  The state of growing half paths from one end of the hamiltonian path
+//  towards the other end. A half path is the same as a path of
+//  canBeHamiltonian of which the first vertex is the other end, so counts are
+//  its option counts, with the same checks.
+struct halfPathSearch {
+    bitset *adjacencyList;
+    bitset includedVertices;
+    bitset allowedVertices;
+    int otherEnd;
+    int length;
+    bool exceeded;
+    struct optionCounts counts;
+};
+
+//  Extends the half path to lastElemOfPath and returns whether the other end
+//  can still be reached over the remaining vertices and these still have
+//  enough options.
+static bool extendHalfPath(struct halfPathSearch *search, bitset path, int
+previousLast, int lastElemOfPath) {
+    bitset remainingVertices = difference(search->includedVertices,
+     union(path, singleton(search->otherEnd)));
+    bool hasOptions = extendOptionCounts(&search->counts,
+     search->adjacencyList, remainingVertices, previousLast, lastElemOfPath,
+     search->otherEnd);
+    return hasOptions && (isEmpty(remainingVertices) ||
+     !isEmpty(intersection(search->adjacencyList[search->otherEnd],
+     remainingVertices)));
+}
+
+//  Undoes extendHalfPath with the same arguments.
+static void retractHalfPath(struct halfPathSearch *search, bitset path, int
+previousLast, int lastElemOfPath) {
+    retractOptionCounts(&search->counts, search->adjacencyList,
+     difference(search->includedVertices, union(path,
+     singleton(search->otherEnd))), previousLast, lastElemOfPath,
+     search->otherEnd);
+}
+
+//  Stores all paths from the start which lie in allowedVertices, consist of
+//  search->length vertices and pass the checks of extendHalfPath, together
+//  with all their initial parts. A path with the same vertices and last
+//  vertex as one which was already stored is not extended again, since its
+//  extensions were already stored.
+static void storeHalfPaths(struct halfPathSearch *search, bitset path, int
+lastElemOfPath) {
+    if(search->exceeded || searchStopped()) {
+        return;
+    }
+    countSearchNode();
+    if(containsHalfPath(path, lastElemOfPath, &search->exceeded) ||
+     size(path) == search->length) {
+        return;
+    }
+    forEach(neighbour, intersection(search->adjacencyList[lastElemOfPath],
+     difference(search->allowedVertices, path))) {
+        bitset extendedPath = union(path, singleton(neighbour));
+        if(extendHalfPath(search, extendedPath, lastElemOfPath, neighbour)) {
+            storeHalfPaths(search, extendedPath, neighbour);
+        }
+        retractHalfPath(search, extendedPath, lastElemOfPath, neighbour);
+    }
+}
+
+//  Grows the paths from the end which lie in allowedVertices up to
+//  search->length vertices and returns whether one of them together with a
+//  stored path from the start, which ends in the same vertex, covers the
+//  included vertices. Stores the paths it grew, with MAXVERTICES added to
+//  their last vertex, so that each is only grown once.
+static bool joinsStoredHalfPath(struct halfPathSearch *search, bitset path,
+int lastElemOfPath) {
+    if(search->exceeded || searchStopped()) {
+        return false;
+    }
+    countSearchNode();
+    if(size(path) == search->length) {
+        return hasHalfPath(union(difference(search->includedVertices, path),
+         singleton(lastElemOfPath)), lastElemOfPath);
+    }
+    if(containsHalfPath(path, lastElemOfPath + MAXVERTICES,
+     &search->exceeded)) {
+        return false;
+    }
+    forEach(neighbour, intersection(search->adjacencyList[lastElemOfPath],
+     difference(search->allowedVertices, path))) {
+        bitset extendedPath = union(path, singleton(neighbour));
+        if(extendHalfPath(search, extendedPath, lastElemOfPath, neighbour) &&
+         joinsStoredHalfPath(search, extendedPath, neighbour)) {
+            return true;
+        }
+        retractHalfPath(search, extendedPath, lastElemOfPath, neighbour);
+    }
+    return false;
+}
+
+//  Returns whether the subgraph spanned by includedVertices, which contains
+//  the distinct vertices start and end and at least one other vertex, has a
+//  hamiltonian (start,end)-path.
+//  The path consists of a path from start of half of its vertices and a path
+//  from end over the other vertices, which meet in some vertex. All first
+//  halves are stored in a hash table by their vertices and last vertex, and
+//  every second half is looked up in it. Sets exceeded and returns false if
+//  the table would exceed searchSettings.meetInTheMiddleMemory.
+static bool containsHamiltonianPathMeetInTheMiddle(bitset adjacencyList[],
+bitset includedVertices, int start, int end, bool *exceeded) {
+    int numberOfVertices = size(includedVertices);
+    int firstHalf = (numberOfVertices + 1) / 2;
+    startHalfPathQuery();
+    struct halfPathSearch search = {.adjacencyList = adjacencyList,
+     .includedVertices = includedVertices, .allowedVertices =
+     difference(includedVertices, singleton(end)), .otherEnd = end, .length
+     = firstHalf, .exceeded = false};
+    if(countOptions(&search.counts, adjacencyList, difference(
+     includedVertices, union(singleton(start), singleton(end))), start,
+     end)) {
+        storeHalfPaths(&search, singleton(start), start);
+    }
+    *exceeded = search.exceeded;
+    if(*exceeded) {
+        return false;
+    }
+
+    //  With at least three vertices, the second half does not reach start.
+    search.allowedVertices = difference(includedVertices, singleton(start));
+    search.otherEnd = start;
+    search.length = numberOfVertices - firstHalf + 1;
+    bool joined = countOptions(&search.counts, adjacencyList, difference(
+     includedVertices, union(singleton(start), singleton(end))), end,
+     start) && joinsStoredHalfPath(&search, singleton(end), end);
+    *exceeded = search.exceeded;
+    return joined && !*exceeded;
+}
+
+struct witnessStatistics witnessStatistics;
+
+//  The number of hamiltonian cycles of subgraphs which every thread keeps
+//  for the graph it is checking.
+#define WITNESSES 8
+
+//  Hamiltonian cycles of subgraphs of the graph with number graphNumber.
+//  The most recently found cycle is at index newest.
+struct witnessCycles {
+    unsigned long long int graphNumber;
+    int numberOfCycles;
+    int newest;
+    int lengths[WITNESSES];
+    int cycles[WITNESSES][MAXVERTICES];
+};
+
+static __thread struct witnessCycles witnessCycles;
+
+//  Keeps the cycle if searchSettings.liftCycles is set, replacing the oldest
+//  one. The cycles of other graphs are dropped first.
+static void storeWitnessCycle(int cycle[], int length) {
+    if(!searchSettings.liftCycles || searchControl.graphNumber == 0) {
+        return;
+    }
+    if(witnessCycles.graphNumber != searchControl.graphNumber) {
+        witnessCycles.graphNumber = searchControl.graphNumber;
+        witnessCycles.numberOfCycles = 0;
+    }
+    witnessCycles.newest = (witnessCycles.newest + 1) % WITNESSES;
+    if(witnessCycles.numberOfCycles < WITNESSES) {
+        witnessCycles.numberOfCycles++;
+    }
+    memcpy(witnessCycles.cycles[witnessCycles.newest], cycle, length *
+     sizeof(int));
+    witnessCycles.lengths[witnessCycles.newest] = length;
+}
+
+//  Tries to turn the cycle into a hamiltonian cycle of the subgraph spanned
+//  by includedVertices, which is stored in lifted. The vertices which are not
+//  included are left out. Where this leaves two consecutive vertices which
+//  are not adjacent, a missing vertex adjacent to both is put in between.
+//  The other missing vertices are inserted between two consecutive vertices
+//  to which they are both adjacent.
+static bool liftCycle(bitset adjacencyList[], int cycle[], int length, bitset
+includedVertices, int lifted[]) {
+    bitset missing = includedVertices;
+    for(int i = 0; i < length; i++) {
+        removeElement(missing, cycle[i]);
+    }
+    int liftedLength = 0;
+    bool gapBefore = false;
+    int firstKept = -1;
+    bool gapAtEnd = false;
+    for(int i = 0; i < length; i++) {
+        int vertex = cycle[i];
+        if(!contains(includedVertices, vertex)) {
+            gapBefore = true;
+            continue;
+        }
+        if(firstKept == -1) {
+            firstKept = i;
+            gapAtEnd = gapBefore;
+        }
+        else if(gapBefore &&
+         !contains(adjacencyList[lifted[liftedLength - 1]], vertex)) {
+            bitset fillers = intersection(missing, intersection(
+             adjacencyList[lifted[liftedLength - 1]], adjacencyList[vertex]));
+            if(isEmpty(fillers)) {
+                return false;
+            }
+            int filler = next(fillers, -1);
+            removeElement(missing, filler);
+            lifted[liftedLength++] = filler;
+        }
+        lifted[liftedLength++] = vertex;
+        gapBefore = false;
+    }
+    if(liftedLength == 0) {
+        return false;
+    }
+
+    //  The gap between the last and the first vertex.
+    if((gapBefore || gapAtEnd) && liftedLength > 1 &&
+     !contains(adjacencyList[lifted[liftedLength - 1]], lifted[0])) {
+        bitset fillers = intersection(missing, intersection(
+         adjacencyList[lifted[liftedLength - 1]], adjacencyList[lifted[0]]));
+        if(isEmpty(fillers)) {
+            return false;
+        }
+        int filler = next(fillers, -1);
+        removeElement(missing, filler);
+        lifted[liftedLength++] = filler;
+    }
+
+    forEach(vertex, missing) {
+        int position = -1;
+        for(int i = 0; i < liftedLength; i++) {
+            if(contains(adjacencyList[vertex], lifted[i]) &&
+             contains(adjacencyList[vertex], lifted[(i + 1) % liftedLength])) {
+                position = i + 1;
+                break;
+            }
+        }
+        if(position == -1) {
+            return false;
+        }
+        memmove(&lifted[position + 1], &lifted[position], (liftedLength -
+         position) * sizeof(int));
+        lifted[position] = vertex;
+        liftedLength++;
+    }
+    return liftedLength >= 3;
+}
+
+//  Returns whether one of the kept cycles of this graph can be lifted to a
+//  hamiltonian cycle of the subgraph spanned by includedVertices.
+static bool liftWitnessCycle(bitset adjacencyList[], bitset
+includedVertices) {
+    if(witnessCycles.graphNumber != searchControl.graphNumber ||
+     searchControl.graphNumber == 0) {
+        return false;
+    }
+    int lifted[MAXVERTICES];
+    for(int i = 0; i < witnessCycles.numberOfCycles; i++) {
+        int witness = (witnessCycles.newest - i + WITNESSES) % WITNESSES;
+        if(liftCycle(adjacencyList, witnessCycles.cycles[witness],
+         witnessCycles.lengths[witness], includedVertices, lifted)) {
+            storeWitnessCycle(lifted, size(includedVertices));
+            return true;
+        }
+    }
+    return false;
+}
+
+struct posaStatistics posaStatistics;
+
+//  Path of the rotation-extension heuristic. position[v] is the index of v in
+//  vertices if v lies in the path.
+struct posaPath {
+    int vertices[MAXVERTICES];
+    int position[MAXVERTICES];
+    int length;
+    bitset inPath;
+    uint64_t random;
+};
+
+static uint64_t nextRandom(struct posaPath *path) {
+    path->random ^= path->random >> 12;
+    path->random ^= path->random << 25;
+    path->random ^= path->random >> 27;
+    return path->random * 0x2545F4914F6CDD1DULL;
+}
+
+static int randomElement(struct posaPath *path, bitset set) {
+    int index = nextRandom(path) % size(set);
+    forEach(element, set) {
+        if(index-- == 0) {
+            return element;
+        }
+    }
+    return -1;
+}
+
+//  Returns the vertices of candidates with the fewest neighbours outside of
+//  the path. Taking these first avoids leaving behind vertices which can no
+//  longer be reached.
+static bitset fewestOptions(bitset adjacencyList[], bitset includedVertices,
+bitset inPath, bitset candidates) {
+    bitset outside = difference(includedVertices, inPath);
+    bitset fewest = EMPTY;
+    int fewestOptions = MAXVERTICES;
+    forEach(candidate, candidates) {
+        int options = size(intersection(adjacencyList[candidate], outside));
+        if(options < fewestOptions) {
+            fewest = EMPTY;
+            fewestOptions = options;
+        }
+        if(options == fewestOptions) {
+            add(fewest, candidate);
+        }
+    }
+    return fewest;
+}
+
+//  Reverses the part of the path from index start up to index end.
+static void reversePath(struct posaPath *path, int start, int end) {
+    while(start < end) {
+        int temp = path->vertices[start];
+        path->vertices[start] = path->vertices[end];
+        path->vertices[end] = temp;
+        path->position[path->vertices[start]] = start;
+        path->position[path->vertices[end]] = end;
+        start++;
+        end--;
+    }
+}
+
+static void appendToPath(struct posaPath *path, int vertex) {
+    path->vertices[path->length] = vertex;
+    path->position[vertex] = path->length++;
+    add(path->inPath, vertex);
+}
+
+//  The number of steps per vertex after which the heuristic starts over if
+//  its path did not get any longer.
+#define RESTARTINTERVAL 1
+
+//  The number of steps per vertex which isTraceable gives the heuristic
+//  before it searches.
+#define TRACEABILITYROTATIONS 20
+
+//  The number of steps of the heuristic between two checks whether the
+//  search was stopped.
+#define ROTATIONCHECKINTERVAL 1024
+
+//  Tries to find a hamiltonian cycle in the subgraph spanned by
+//  includedVertices with at most budget rotations and extensions, or only a
+//  hamiltonian path if pathFlag is true. The path is extended at its last
+//  vertex with a random neighbour outside of it. If there is none, a random
+//  neighbour in the path is joined to the last vertex and the part after it
+//  is reversed. If the path closes a cycle which does not contain all
+//  vertices, it is broken up next to a vertex adjacent to the rest. Returns
+//  false if the budget runs out, which does not mean that the subgraph is
+//  non-hamiltonian.
+static bool findCycleByRotations(bitset adjacencyList[], bitset
+includedVertices, int budget, bool pathFlag) {
+    int numberOfIncluded = size(includedVertices);
+    struct posaPath path = {.length = 0, .inPath = EMPTY};
+
+    //  Seeded by the subgraph, so a query always has the same outcome.
+    path.random = 0x9E3779B97F4A7C15ULL;
+    forEach(vertex, includedVertices) {
+        path.random = (path.random ^ vertex) * 0xBF58476D1CE4E5B9ULL;
+    }
+    path.random |= 1;
+    int longestLength = 0;
+    int stepsWithoutProgress = 0;
+    for(int step = 0; step < budget; step++) {
+        if(step % ROTATIONCHECKINTERVAL == 0 && searchStoppedOrLate()) {
+            return false;
+        }
+
+        //  Start over from a random vertex if the path stopped growing.
+        if(path.length > longestLength) {
+            longestLength = path.length;
+            stepsWithoutProgress = 0;
+        }
+        if(path.length == 0 ||
+         ++stepsWithoutProgress > RESTARTINTERVAL * numberOfIncluded) {
+            path.length = 0;
+            path.inPath = EMPTY;
+            appendToPath(&path, randomElement(&path, includedVertices));
+            longestLength = 1;
+            stepsWithoutProgress = 0;
+        }
+        int last = path.vertices[path.length - 1];
+        int first = path.vertices[0];
+        bitset neighbours = intersection(adjacencyList[last],
+         includedVertices);
+        if(path.length == numberOfIncluded) {
+            if(pathFlag) {
+                return true;
+            }
+            if(contains(neighbours, first)) {
+                storeWitnessCycle(path.vertices, path.length);
+                return true;
+            }
+        }
+        else {
+            bitset outside = difference(neighbours, path.inPath);
+            if(!isEmpty(outside)) {
+                appendToPath(&path, randomElement(&path,
+                 fewestOptions(adjacencyList, includedVertices, path.inPath,
+                 outside)));
+                continue;
+            }
+
+            //  Break up the cycle formed by the path next to a vertex which
+            //  has a neighbour outside of it.
+            if(path.length > 2 && contains(neighbours, first)) {
+                int rotation = randomElement(&path, path.inPath);
+                bool broken = false;
+                for(int i = 0; i < path.length && !broken; i++) {
+                    int vertex = path.vertices[(rotation + i) % path.length];
+                    bitset vertexOutside = difference(intersection(
+                     adjacencyList[vertex], includedVertices), path.inPath);
+                    if(isEmpty(vertexOutside)) {
+                        continue;
+                    }
+
+                    //  Rotate the cycle so that vertex is the last vertex.
+                    int index = path.position[vertex];
+                    reversePath(&path, 0, index);
+                    reversePath(&path, index + 1, path.length - 1);
+                    reversePath(&path, 0, path.length - 1);
+                    appendToPath(&path, randomElement(&path, vertexOutside));
+                    broken = true;
+                }
+                if(broken) {
+                    continue;
+                }
+            }
+        }
+
+        //  Rotate at a neighbour of the last vertex which is not its
+        //  predecessor. If there is none, continue at the other end.
+        bitset rotations = difference(intersection(neighbours, path.inPath),
+         union(singleton(last), path.length > 1 ?
+         singleton(path.vertices[path.length - 2]) : EMPTY));
+        if(isEmpty(rotations)) {
+            reversePath(&path, 0, path.length - 1);
+            continue;
+        }
+        int pivot = path.position[randomElement(&path, rotations)];
+        reversePath(&path, pivot + 1, path.length - 1);
+    }
+    return false;
+}
+
+//  Searches for hamiltonian cycles in the subgraph spanned by
+//  includedVertices by extending all paths through an included vertex of
+//  lowest degree. Returns the number of hamiltonian cycles if allCyclesFlag
+//  is true and otherwise whether there is one.
+static int searchHamiltonianCycles(bitset adjacencyList[], int
+numberOfVertices, bitset includedVertices, bool allCyclesFlag, bool
+verboseFlag) {
+    int numberOfHamiltonianCycles = 0;
+
+    // First included vertex.
+    int startingVertex = next(includedVertices,-1);
+    int lowestDegree = size(adjacencyList[startingVertex]);
+
+    //  Find an included vertex of lowest degree.
+    forEachAfterIndex(includedVertex, includedVertices, startingVertex){
+        int degreeOfNeighbour = 
          size(intersection(adjacencyList[includedVertex], includedVertices));
         if(lowestDegree > degreeOfNeighbour) {
             lowestDegree = degreeOfNeighbour;
@@ -185,6 +2067,28 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag) {
         }
     }
 
+    //  Divide the search for all starting paths over multiple threads.
+    if(!allCyclesFlag && !verboseFlag && searchSettings.searchThreads > 1) {
+        bitset neighbours = intersection(adjacencyList[startingVertex],
+         includedVertices);
+        int numberOfPaths = size(neighbours) * (size(neighbours) - 1) / 2;
+        if(numberOfPaths == 0) return false;
+        struct pathState paths[numberOfPaths];
+        int path = 0;
+        forEach(secondElemOfPath, neighbours) {
+            forEachAfterIndex(lastElemOfPath, neighbours, secondElemOfPath) {
+                paths[path++] = (struct pathState) {.remainingVertices =
+                 difference(includedVertices, union(singleton(startingVertex),
+                 union(singleton(secondElemOfPath),
+                 singleton(lastElemOfPath)))), .lastElemOfPath =
+                 lastElemOfPath, .firstElemOfPath = secondElemOfPath,
+                 .pathLength = 3};
+            }
+        }
+        return canBeHamiltonianForSomePath(adjacencyList,
+         size(includedVertices), paths, numberOfPaths);
+    }
+
     // Loop over included neighbours of startingVertex and for each such
     // neighbour loop over the included neighbours of startingVertex that are
     // of higher index.
@@ -204,6 +2108,9 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag) {
                 // Check if this path can be extended to some hamiltonian cycle.
                 if (canBeHamiltonian(adjacencyList, remainingVertices,
                  lastElemOfPath, secondElemOfPath, size(includedVertices), 3)) {
+                    foundPath[0] = secondElemOfPath;
+                    foundPath[1] = startingVertex;
+                    storeWitnessCycle(foundPath, size(includedVertices));
                     return true;
                 }
                 continue;
@@ -225,6 +2132,51 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag) {
             }
         }
     }
+    return numberOfHamiltonianCycles;
+}
+
+static bool isHamiltonianSubgraph(bitset adjacencyList[], int
+numberOfVertices, bitset excludedVertices, bool allCyclesFlag, bool
+verboseFlag) { 
+
+    //  We check whether the subgraph spanned by the included vertices is
+    //  hamiltonian.
+    bitset includedVertices = complement(excludedVertices, numberOfVertices);
+
+    if(isEmpty(includedVertices)) return false;
+
+    if(!allCyclesFlag && !verboseFlag && useHeldKarp(numberOfVertices)) {
+        return isHamiltonianHeldKarp(adjacencyList, numberOfVertices,
+         includedVertices);
+    }
+
+    //  Try to repair a cycle found in another subgraph of this graph.
+    if(!allCyclesFlag && !verboseFlag && searchSettings.liftCycles) {
+        atomic_fetch_add_explicit(&witnessStatistics.attempts, 1,
+         memory_order_relaxed);
+        if(liftWitnessCycle(adjacencyList, includedVertices)) {
+            atomic_fetch_add_explicit(&witnessStatistics.lifted, 1,
+             memory_order_relaxed);
+            return true;
+        }
+    }
+
+    //  Most subgraphs are hamiltonian, which a heuristic often shows much
+    //  faster than the search.
+    if(!allCyclesFlag && !verboseFlag && searchSettings.posaBudget > 0 &&
+     size(includedVertices) >= 3) {
+        atomic_fetch_add_explicit(&posaStatistics.attempts, 1,
+         memory_order_relaxed);
+        if(findCycleByRotations(adjacencyList, includedVertices,
+         searchSettings.posaBudget, false)) {
+            atomic_fetch_add_explicit(&posaStatistics.successes, 1,
+             memory_order_relaxed);
+            return true;
+        }
+    }
+
+    int numberOfHamiltonianCycles = searchHamiltonianCycles(adjacencyList,
+     numberOfVertices, includedVertices, allCyclesFlag, verboseFlag);
     if(allCyclesFlag) {
        fprintf(stderr,"There were %d hamiltonian cycles in this (sub)graph.\n\n",
         numberOfHamiltonianCycles);
@@ -234,6 +2186,31 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag) {
     return numberOfHamiltonianCycles;
 }
 
+//  Records the subgraph without excludedVertices in searchControl.cost if it
+//  took more nodes than the most expensive subgraph so far.
+static void recordSubgraphCost(bitset excludedVertices, long long int nodes) {
+    struct searchCost *cost = searchControl.cost;
+    pthread_mutex_lock(&cost->mutex);
+    if(nodes > cost->dominatingNodes) {
+        cost->dominatingNodes = nodes;
+        cost->dominatingSubgraph = excludedVertices;
+    }
+    pthread_mutex_unlock(&cost->mutex);
+}
+
+bool isHamiltonian(bitset adjacencyList[], int numberOfVertices, bitset
+excludedVertices, bool allCyclesFlag, bool verboseFlag) {
+    if(searchControl.cost == NULL || isEmpty(excludedVertices)) {
+        return isHamiltonianSubgraph(adjacencyList, numberOfVertices,
+         excludedVertices, allCyclesFlag, verboseFlag);
+    }
+    long long int nodes = searchNodesOfThread();
+    bool hamiltonian = isHamiltonianSubgraph(adjacencyList, numberOfVertices,
+     excludedVertices, allCyclesFlag, verboseFlag);
+    recordSubgraphCost(excludedVertices, searchNodesOfThread() - nodes);
+    return hamiltonian;
+}
+
 bool hasMinimumDegree(bitset adjacencyList[], int numberOfVertices, int
 degree) {
 
@@ -246,6 +2223,452 @@ degree) {
     return true;
 }
 
+//  Depth-first search which determines whether a graph contains a cut
+//  vertex.
+struct cutVertexSearch {
+    bitset *adjacencyList;
+    bitset vertices;
+    int time;
+    int discovered[MAXVERTICES];
+    int low[MAXVERTICES];
+};
+
+//  Returns true if some vertex of the search tree below vertex, or vertex
+//  itself if it is not the root, is a cut vertex.
+static bool reachesCutVertex(struct cutVertexSearch *search, int vertex, bool
+isRoot) {
+    search->discovered[vertex] = search->low[vertex] = ++search->time;
+    int children = 0;
+    forEach(neighbour, intersection(search->adjacencyList[vertex],
+     search->vertices)) {
+        if(search->discovered[neighbour]) {
+            if(search->low[vertex] > search->discovered[neighbour]) {
+                search->low[vertex] = search->discovered[neighbour];
+            }
+            continue;
+        }
+        children++;
+        if(reachesCutVertex(search, neighbour, false)) {
+            return true;
+        }
+        if(search->low[vertex] > search->low[neighbour]) {
+            search->low[vertex] = search->low[neighbour];
+        }
+        if(!isRoot && search->low[neighbour] >= search->discovered[vertex]) {
+            return true;
+        }
+    }
+
+    //  The root is a cut vertex if it has multiple subtrees.
+    return isRoot && children > 1;
+}
+
+//  Returns whether the subgraph spanned by vertices is connected and has no
+//  cut vertex.
+static bool hasNoCutVertex(bitset adjacencyList[], bitset vertices) {
+    struct cutVertexSearch search = {.adjacencyList = adjacencyList,
+     .vertices = vertices};
+    forEach(vertex, vertices) {
+        search.discovered[vertex] = 0;
+    }
+    if(reachesCutVertex(&search, next(vertices, -1), true)) {
+        return false;
+    }
+    return search.time == size(vertices);
+}
+
+bool isKConnected(bitset adjacencyList[], int numberOfVertices, bitset
+excludedVertices, int k) {
+    bitset includedVertices = complement(excludedVertices, numberOfVertices);
+    if(size(includedVertices) <= k) {
+        return false;
+    }
+    switch(k) {
+        case 1:
+            return isConnectedSubgraph(adjacencyList, includedVertices);
+        case 2:
+            return hasNoCutVertex(adjacencyList, includedVertices);
+        case 3:
+
+            //  Every vertex-deleted subgraph has to be 2-connected.
+            forEach(vertex, includedVertices) {
+                if(!hasNoCutVertex(adjacencyList, difference(includedVertices,
+                 singleton(vertex)))) {
+                    return false;
+                }
+            }
+            return true;
+    }
+    fprintf(stderr, "Error: %d-connectivity cannot be checked.\n", k);
+    exit(1);
+}
+
+//  The subgraphs of a graph which we check in parallel. As soon as one of
+//  them fails the check, the searches in the other subgraphs get cancelled.
+struct subgraphChecks {
+    bitset *adjacencyList;
+    int numberOfVertices;
+    bitset *excludedVertices;
+    bool (*check)(bitset adjacencyList[], int numberOfVertices, bitset
+     excludedVertices);
+    atomic_bool failed;
+    unsigned long long int graphNumber;
+    struct searchBudget *budget;
+    struct searchCost *cost;
+
+    //  The search nodes visited in all subgraphs.
+    atomic_llong nodes;
+};
+
+static void checkSubgraph(void *argument, int subgraph) {
+    struct subgraphChecks *checks = argument;
+    if(atomic_load_explicit(&checks->failed, memory_order_relaxed)) {
+        return;
+    }
+    struct searchControl oldControl = searchControl;
+    searchControl.cancelled = &checks->failed;
+    searchControl.parentCancelled = NULL;
+    searchControl.graphNumber = checks->graphNumber;
+    setSearchBudget(checks->budget);
+    searchControl.cost = checks->cost;
+    long long int nodes = searchNodesOfThread();
+    if(!checks->check(checks->adjacencyList, checks->numberOfVertices,
+     checks->excludedVertices[subgraph])) {
+        atomic_store(&checks->failed, true);
+    }
+    flushSearchNodes();
+    searchControl = oldControl;
+    moveNodesToSearch(nodes, &checks->nodes);
+}
+
+//  Returns whether check holds for all subgraphs spanned by the vertices not
+//  in excludedVertices[i]. These are divided over
+//  searchSettings.subgraphThreads threads.
+static bool allSubgraphsSatisfy(bitset adjacencyList[], int numberOfVertices,
+bitset excludedVertices[], int numberOfSubgraphs, bool (*check)(bitset
+adjacencyList[], int numberOfVertices, bitset excludedVertices)) {
+    struct subgraphChecks checks = {.adjacencyList = adjacencyList,
+     .numberOfVertices = numberOfVertices, .excludedVertices =
+     excludedVertices, .check = check, .graphNumber =
+     searchControl.graphNumber, .budget = searchControl.budget, .cost =
+     searchControl.cost};
+    atomic_init(&checks.failed, false);
+    atomic_init(&checks.nodes, 0);
+    runTasks(searchSettings.subgraphThreads, numberOfSubgraphs, checkSubgraph,
+     &checks);
+    countedNodes += atomic_load(&checks.nodes);
+    return !atomic_load(&checks.failed);
+}
+
+static bool subgraphIsHamiltonian(bitset adjacencyList[], int
+numberOfVertices, bitset excludedVertices) {
+    return isHamiltonian(adjacencyList, numberOfVertices, excludedVertices,
+     false, false);
+}
+
+static bool subgraphIsTraceable(bitset adjacencyList[], int numberOfVertices,
+bitset excludedVertices) {
+    return isTraceable(adjacencyList, numberOfVertices, excludedVertices,
+     false, false);
+}
+
+static int countEdges(bitset adjacencyList[], int numberOfVertices) {
+    int numberOfEdges = 0;
+    for (int i = 0; i < numberOfVertices; i++) {
+        numberOfEdges += size(adjacencyList[i]);
+    }
+    return numberOfEdges / 2;
+}
+
+struct orbitStatistics orbitStatistics;
+
+//  Returns the vertices v for which G - v needs to be checked. If
+//  reduceByOrbits is true and searchSettings.orbitReduction is set, this is
+//  one vertex of every orbit of the automorphism group, since the other
+//  vertex-deleted subgraphs are isomorphic to one of these. Otherwise these
+//  are all vertices.
+static bitset verticesToDelete(bitset adjacencyList[], int numberOfVertices,
+bool reduceByOrbits) {
+    if(!reduceByOrbits || !searchSettings.orbitReduction) {
+        return complement(EMPTY, numberOfVertices);
+    }
+    bitset vertices = vertexOrbitRepresentatives(adjacencyList,
+     numberOfVertices, NULL, 0);
+    atomic_fetch_add_explicit(&orbitStatistics.subgraphs, numberOfVertices,
+     memory_order_relaxed);
+    atomic_fetch_add_explicit(&orbitStatistics.skipped, numberOfVertices -
+     size(vertices), memory_order_relaxed);
+    return vertices;
+}
+
+//  Stores in edges[v] the vertices w > v for which G - v - w needs to be
+//  checked. These are reduced to one edge of every orbit like in
+//  verticesToDelete.
+static void edgesToDelete(bitset adjacencyList[], int numberOfVertices, bool
+reduceByOrbits, bitset edges[]) {
+    if(!reduceByOrbits || !searchSettings.orbitReduction) {
+        for (int i = 0; i < numberOfVertices; i++) {
+            edges[i] = difference(adjacencyList[i], complement(EMPTY, i + 1));
+        }
+        return;
+    }
+    edgeOrbitRepresentatives(adjacencyList, numberOfVertices, NULL, 0, edges);
+    int numberOfRepresentatives = 0;
+    for (int i = 0; i < numberOfVertices; i++) {
+        numberOfRepresentatives += size(edges[i]);
+    }
+    int numberOfEdges = countEdges(adjacencyList, numberOfVertices);
+    atomic_fetch_add_explicit(&orbitStatistics.subgraphs, numberOfEdges,
+     memory_order_relaxed);
+    atomic_fetch_add_explicit(&orbitStatistics.skipped, numberOfEdges -
+     numberOfRepresentatives, memory_order_relaxed);
+}
+
+//  Stores {v} for every v in vertices in vertexDeletions and returns their
+//  number.
+static int listVertexDeletions(bitset vertices, bitset vertexDeletions[]) {
+    int numberOfDeletions = 0;
+    forEach(vertex, vertices) {
+        vertexDeletions[numberOfDeletions++] = singleton(vertex);
+    }
+    return numberOfDeletions;
+}
+
+//  Stores the set {v,w} for every edge vw with w in edges[v] in
+//  edgeDeletions, which should have room for all edges, and returns their
+//  number.
+static int listEdgeDeletions(bitset edges[], int numberOfVertices, bitset
+edgeDeletions[]) {
+    int edge = 0;
+    for (int i = 0; i < numberOfVertices; i++) {
+        forEach(neighbour, edges[i]) {
+            edgeDeletions[edge++] = union(singleton(i), singleton(neighbour));
+        }
+    }
+    return edge;
+}
+
+//  A search for cycles which skip a single vertex (skipSize 1) or the two
+//  ends of a single edge (skipSize 2) and contain all other vertices. The
+//  skipped vertices of every such cycle form a target which is covered,
+//  i.e. the graph without them was shown to be hamiltonian.
+struct skipSearch {
+    bitset *adjacencyList;
+    int skipSize;
+
+    //  The uncovered vertices if skipSize is 1. Otherwise the vertices which
+    //  lie in some uncovered pair.
+    bitset uncoveredVertices;
+
+    //  If skipSize is 2, uncoveredPairs[v] contains w if the edge vw is an
+    //  uncovered target.
+    bitset uncoveredPairs[MAXVERTICES];
+    int numberOfUncoveredTargets;
+};
+
+static bool isUncoveredTarget(struct skipSearch *search, bitset skipped) {
+    int v = next(skipped, -1);
+
+    //  The empty set is not a target.
+    if(v < 0) {
+        return false;
+    }
+    if(search->skipSize == 1) {
+        return contains(search->uncoveredVertices, v);
+    }
+    return contains(search->uncoveredPairs[v], next(skipped, v));
+}
+
+static void coverTarget(struct skipSearch *search, bitset skipped) {
+    int v = next(skipped, -1);
+    search->numberOfUncoveredTargets--;
+    if(search->skipSize == 1) {
+        removeElement(search->uncoveredVertices, v);
+        return;
+    }
+    int w = next(skipped, v);
+    removeElement(search->uncoveredPairs[v], w);
+    removeElement(search->uncoveredPairs[w], v);
+    if(isEmpty(search->uncoveredPairs[v])) {
+        removeElement(search->uncoveredVertices, v);
+    }
+    if(isEmpty(search->uncoveredPairs[w])) {
+        removeElement(search->uncoveredVertices, w);
+    }
+}
+
+//  Returns whether some uncovered target consists of remaining vertices.
+static bool hasUncoveredTargetIn(struct skipSearch *search, bitset
+remainingVertices) {
+    bitset candidates = intersection(search->uncoveredVertices,
+     remainingVertices);
+    if(search->skipSize == 1) {
+        return !isEmpty(candidates);
+    }
+    forEach(v, candidates) {
+        if(!isEmpty(intersection(search->uncoveredPairs[v],
+         remainingVertices))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//  Covers skipped if it is an uncovered target and the path can be extended
+//  to a cycle through all remaining vertices except skipped.
+static void coverIfHamiltonian(struct skipSearch *search, bitset
+remainingVertices, bitset skipped, int lastElemOfPath, int firstElemOfPath,
+int pathLength) {
+    if(!isUncoveredTarget(search, skipped)) {
+        return;
+    }
+    bitset cycleVertices = difference(remainingVertices, skipped);
+    if(canBeHamiltonian(search->adjacencyList, cycleVertices, lastElemOfPath,
+     firstElemOfPath, pathLength + size(cycleVertices), pathLength)) {
+        coverTarget(search, skipped);
+    }
+}
+
+//  Extends the path in all possible ways into cycles which skip an uncovered
+//  target among the remaining vertices, and covers these targets. As soon
+//  as the vertices which have to be skipped are known, the rest of the cycle
+//  is left to canBeHamiltonian.
+static void coverSkippedTargets(struct skipSearch *search, bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, int pathLength) {
+    if(search->numberOfUncoveredTargets == 0 || searchStopped()) {
+        return;
+    }
+    countSearchNode();
+    if(size(remainingVertices) == search->skipSize) {
+        coverIfHamiltonian(search, remainingVertices, remainingVertices,
+         lastElemOfPath, firstElemOfPath, pathLength);
+        return;
+    }
+
+    //  Remaining vertices without two possible neighbours in the cycle can
+    //  only be skipped.
+    bitset remainingWithFirstAndLast = union(remainingVertices,
+     union(singleton(firstElemOfPath), singleton(lastElemOfPath)));
+    bitset mustBeSkipped = EMPTY;
+    forEach(vertex, remainingVertices) {
+        if(size(intersection(search->adjacencyList[vertex],
+         remainingWithFirstAndLast)) < 2) {
+            add(mustBeSkipped, vertex);
+        }
+    }
+    int numberOfSkipped = size(mustBeSkipped);
+    if(numberOfSkipped > search->skipSize) {
+        return;
+    }
+    if(numberOfSkipped == search->skipSize) {
+        coverIfHamiltonian(search, remainingVertices, mustBeSkipped,
+         lastElemOfPath, firstElemOfPath, pathLength);
+        return;
+    }
+    if(numberOfSkipped == 1) {
+        int v = next(mustBeSkipped, -1);
+        forEach(w, intersection(search->uncoveredPairs[v],
+         remainingVertices)) {
+            coverIfHamiltonian(search, remainingVertices,
+             union(mustBeSkipped, singleton(w)), lastElemOfPath,
+             firstElemOfPath, pathLength);
+        }
+        return;
+    }
+    if(!hasUncoveredTargetIn(search, remainingVertices)) {
+        return;
+    }
+    forEach(neighbour, intersection(search->adjacencyList[lastElemOfPath],
+     remainingVertices)) {
+        coverSkippedTargets(search, difference(remainingVertices,
+         singleton(neighbour)), neighbour, firstElemOfPath, pathLength + 1);
+    }
+}
+
+//  Returns whether all targets of the search get covered by a cycle which
+//  passes through startingVertex. Like in searchHamiltonianCycles the paths
+//  start with startingVertex between two of its neighbours.
+static bool coversAllTargets(struct skipSearch *search, int numberOfVertices,
+int startingVertex) {
+    bitset *adjacencyList = search->adjacencyList;
+    bitset vertices = complement(EMPTY, numberOfVertices);
+    forEach(secondElemOfPath, adjacencyList[startingVertex]) {
+        forEachAfterIndex(lastElemOfPath, adjacencyList[startingVertex],
+         secondElemOfPath) {
+            bitset path = union(singleton(startingVertex),
+             union(singleton(secondElemOfPath), singleton(lastElemOfPath)));
+            coverSkippedTargets(search, difference(vertices, path),
+             lastElemOfPath, secondElemOfPath, 3);
+            if(search->numberOfUncoveredTargets == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//  Returns the vertex of lowest degree.
+static int vertexOfLowestDegree(bitset adjacencyList[], int
+numberOfVertices) {
+    int vertex = 0;
+    for(int i = 1; i < numberOfVertices; i++) {
+        if(size(adjacencyList[i]) < size(adjacencyList[vertex])) {
+            vertex = i;
+        }
+    }
+    return vertex;
+}
+
+//  Returns whether G - v is hamiltonian for every v in vertices, using one
+//  skip search for all these vertices except the starting vertex.
+static bool allVertexDeletionsHamiltonian(bitset adjacencyList[], int
+numberOfVertices, bitset vertices) {
+    int startingVertex = vertexOfLowestDegree(adjacencyList,
+     numberOfVertices);
+    if(contains(vertices, startingVertex) && !isHamiltonian(adjacencyList,
+     numberOfVertices, singleton(startingVertex), false, false)) {
+        return false;
+    }
+    bitset targets = difference(vertices, singleton(startingVertex));
+    struct skipSearch search = {.adjacencyList = adjacencyList, .skipSize = 1,
+     .uncoveredVertices = targets, .numberOfUncoveredTargets =
+     size(targets)};
+    return search.numberOfUncoveredTargets == 0 || coversAllTargets(&search,
+     numberOfVertices, startingVertex);
+}
+
+//  Returns whether G - v - w is hamiltonian for every edge vw with w in
+//  edges[v], using one skip search for all these edges which do not contain
+//  the starting vertex.
+static bool allEdgeDeletionsHamiltonian(bitset adjacencyList[], int
+numberOfVertices, bitset edges[]) {
+    int startingVertex = vertexOfLowestDegree(adjacencyList,
+     numberOfVertices);
+    struct skipSearch search = {.adjacencyList = adjacencyList, .skipSize = 2,
+     .uncoveredVertices = EMPTY, .numberOfUncoveredTargets = 0};
+    for(int v = 0; v < numberOfVertices; v++) {
+        search.uncoveredPairs[v] = EMPTY;
+    }
+    for(int v = 0; v < numberOfVertices; v++) {
+        forEach(w, edges[v]) {
+            if(v == startingVertex || w == startingVertex) {
+                if(!isHamiltonian(adjacencyList, numberOfVertices,
+                 union(singleton(v), singleton(w)), false, false)) {
+                    return false;
+                }
+                continue;
+            }
+            add(search.uncoveredPairs[v], w);
+            add(search.uncoveredPairs[w], v);
+            add(search.uncoveredVertices, v);
+            add(search.uncoveredVertices, w);
+            search.numberOfUncoveredTargets++;
+        }
+    }
+    return search.numberOfUncoveredTargets == 0 || coversAllTargets(&search,
+     numberOfVertices, startingVertex);
+}
+
 bool isK1Hamiltonian(bitset adjacencyList[], int numberOfVertices, bool
 verboseFlag, bool allCyclesFlag, int vertexToCheck) {
 
@@ -257,13 +2680,29 @@ verboseFlag, bool allCyclesFlag, int vertexToCheck) {
         return false;
     }
 
+    bitset vertices = verticesToDelete(adjacencyList, numberOfVertices,
+     !verboseFlag);
+
+    if(!verboseFlag && searchSettings.skipSearch) {
+        return allVertexDeletionsHamiltonian(adjacencyList, numberOfVertices,
+         vertices);
+    }
+
+    if(!verboseFlag && searchSettings.subgraphThreads > 1) {
+        bitset vertexDeletions[numberOfVertices];
+        int numberOfDeletions = listVertexDeletions(vertices,
+         vertexDeletions);
+        return allSubgraphsSatisfy(adjacencyList, numberOfVertices,
+         vertexDeletions, numberOfDeletions, subgraphIsHamiltonian);
+    }
+
     //  An exceptional vertex is one for which the vertex-deleted subgraph is
     //  non-hamiltonian. 
     bitset exceptionalVertices = EMPTY;
 
     //  Loop over all vertices and determine whether the vertex-deleted
     //  subgraph is hamiltonian.
-    for (int i = 0; i < numberOfVertices; i++) {
+    forEach(i, vertices) {
         bitset excludedVertices = singleton(i);
         if(!verboseFlag) {
             if(!(isHamiltonian(adjacencyList,numberOfVertices,excludedVertices,
@@ -320,6 +2759,22 @@ verboseFlag, bool allCyclesFlag, int vertexPairToCheck[]) {
         return false;
     }
 
+    bitset edges[numberOfVertices];
+    edgesToDelete(adjacencyList, numberOfVertices, !verboseFlag, edges);
+
+    if(!verboseFlag && searchSettings.skipSearch) {
+        return allEdgeDeletionsHamiltonian(adjacencyList, numberOfVertices,
+         edges);
+    }
+
+    if(!verboseFlag && searchSettings.subgraphThreads > 1) {
+        bitset edgeDeletions[countEdges(adjacencyList, numberOfVertices)];
+        int numberOfEdges = listEdgeDeletions(edges, numberOfVertices,
+         edgeDeletions);
+        return allSubgraphsSatisfy(adjacencyList, numberOfVertices,
+         edgeDeletions, numberOfEdges, subgraphIsHamiltonian);
+    }
+
     // Pairs (v,w) for which G - v - w is not hamiltonian.
     bitset exceptionalPairs[numberOfVertices];
     if(verboseFlag) {
@@ -333,7 +2788,7 @@ verboseFlag, bool allCyclesFlag, int vertexPairToCheck[]) {
     //  hamiltonian.
     for (int i = 0; i < numberOfVertices; i++) {
         bitset excludedVertices = singleton(i);
-        forEachAfterIndex(neighbour, adjacencyList[i], i) {
+        forEach(neighbour, edges[i]) {
             add(excludedVertices, neighbour);
             if(!verboseFlag) {
                 if(!(isHamiltonian(adjacencyList, numberOfVertices,
@@ -395,11 +2850,28 @@ allCyclesFlag, bool verboseFlag) {
     bitset includedVertices = complement(excludedVertices, numberOfVertices);
     bitset remainingVertices = difference(includedVertices, path);
     if(!verboseFlag && !allCyclesFlag) {
+        if(start != end && useHeldKarp(numberOfVertices)) {
+            return containsHamiltonianPathHeldKarp(adjacencyList,
+             numberOfVertices, includedVertices, start, end);
+        }
+        if(start != end && searchSettings.meetInTheMiddleMemory > 0 &&
+         size(includedVertices) > 2) {
+            atomic_fetch_add_explicit(&meetInTheMiddleStatistics.queries, 1,
+             memory_order_relaxed);
+            bool exceeded;
+            bool result = containsHamiltonianPathMeetInTheMiddle(
+             adjacencyList, includedVertices, start, end, &exceeded);
+            if(!exceeded) {
+                return result;
+            }
+            atomic_fetch_add_explicit(&meetInTheMiddleStatistics.fallbacks, 1,
+             memory_order_relaxed);
+        }
 
         //  Will return true if this path can be extended to a hamiltonian
         //  path between start and end and false otherwise..
-        return canBeHamiltonian(adjacencyList, remainingVertices, start, end,
-         size(includedVertices), 2);
+        return canBeHamiltonianInParallel(adjacencyList, remainingVertices,
+         start, end, size(includedVertices), 2);
     }
 
     //  Only gets executed if -v or -a are present.
@@ -422,16 +2894,299 @@ allCyclesFlag, bool verboseFlag) {
     return nOfPaths;
 }
 
-bool isPartOfDisjointSpanningPaths(bitset adjacencyList[], bitset currentPath,
-bitset excludedVertices, int pathList[], int firstElemOfPath, int
-lastElemOfPath, bitset verticesContainedByPath1, int numberOfVertices, int
-firstElemOfPath2, int lastElemOfPath2, bitset verticesContainedByPath2, int*
-nOfSpanningPaths, bool allCyclesFlag, bool verboseFlag)  { 
+//  The state of findHamiltonianPathEnds, where unresolvedPairs are the
+//  requested pairs of which it is not known yet whether they have a path and
+//  rotatedPairs the pairs of ends of the rotated paths visited so far.
+struct pathEndSearch {
+    bitset *adjacencyList;
+    bitset *unresolvedPairs;
+    bitset *rotatedPairs;
+    bitset *pathEnds;
+    int numberOfUnresolvedPairs;
+    bool anyPairFlag;
+    bool done;
+};
+
+//  Records a hamiltonian path between start and end.
+static void addPathEnds(struct pathEndSearch *search, int start, int end) {
+    add(search->pathEnds[start], end);
+    add(search->pathEnds[end], start);
+    removeElement(search->unresolvedPairs[start], end);
+    removeElement(search->unresolvedPairs[end], start);
+    search->numberOfUnresolvedPairs--;
+    search->done = search->anyPairFlag || search->numberOfUnresolvedPairs == 0;
+}
+
+//  Resolves the unresolved pairs which are the ends of a hamiltonian path
+//  obtained from path by rotations, as in findCycleByRotations. If the last
+//  vertex is adjacent to the vertex at index i, reversing the part after it
+//  gives a hamiltonian path ending in the vertex at index i + 1, and
+//  similarly at the first vertex. Every pair of ends is rotated from once,
+//  and only at an end of which the other end still has unresolved pairs.
+static void addRotatedPathEnds(struct pathEndSearch *search, struct posaPath
+*path) {
+    int end = path->length - 1;
+    int first = path->vertices[0];
+    int last = path->vertices[end];
+    add(search->rotatedPairs[first], last);
+    add(search->rotatedPairs[last], first);
+    if(contains(search->unresolvedPairs[first], last)) {
+        addPathEnds(search, first, last);
+    }
+    forEach(neighbour, intersection(search->adjacencyList[last],
+     path->inPath)) {
+        int i = path->position[neighbour];
+        if(search->done || isEmpty(search->unresolvedPairs[first])) {
+            break;
+        }
+        if(i < end - 1 && !contains(search->rotatedPairs[first],
+         path->vertices[i + 1])) {
+            reversePath(path, i + 1, end);
+            addRotatedPathEnds(search, path);
+            reversePath(path, i + 1, end);
+        }
+    }
+    forEach(neighbour, intersection(search->adjacencyList[first],
+     path->inPath)) {
+        int i = path->position[neighbour];
+        if(search->done || isEmpty(search->unresolvedPairs[last])) {
+            return;
+        }
+        if(i > 1 && !contains(search->rotatedPairs[last],
+         path->vertices[i - 1])) {
+            reversePath(path, 0, i - 1);
+            addRotatedPathEnds(search, path);
+            reversePath(path, 0, i - 1);
+        }
+    }
+}
+
+//  Resolves the pair of start and end by a search for a hamiltonian path
+//  between them. The path which is found is rotated to resolve other pairs,
+//  unless the search is one which does not return its path.
+static void searchPathEnds(struct pathEndSearch *search, int numberOfVertices,
+bitset includedVertices, int start, int end) {
+    if(searchSettings.searchThreads > 1 ||
+     searchSettings.meetInTheMiddleMemory > 0) {
+        if(containsHamiltonianPathWithEnds(search->adjacencyList,
+         numberOfVertices, complement(includedVertices, numberOfVertices),
+         start, end, false, false)) {
+            addPathEnds(search, start, end);
+        }
+        return;
+    }
+    int pathLength = size(includedVertices);
+    bitset remainingVertices = difference(includedVertices,
+     union(singleton(start), singleton(end)));
+    if(canBeHamiltonian(search->adjacencyList, remainingVertices, start, end,
+     pathLength, 2)) {
+
+        //  The cycle found consists of end, start and the path between them.
+        struct posaPath path = {.length = 0, .inPath = EMPTY};
+        for(int i = 1; i < pathLength; i++) {
+            appendToPath(&path, foundPath[i]);
+        }
+        appendToPath(&path, end);
+        addRotatedPathEnds(search, &path);
+    }
+}
+
+bool findHamiltonianPathEnds(bitset adjacencyList[], int numberOfVertices,
+bitset excludedVertices, bitset requestedPairs[], bool anyPairFlag, bitset
+pathEnds[]) {
+    bitset includedVertices = complement(excludedVertices, numberOfVertices);
+    bitset unresolvedPairs[numberOfVertices];
+    bitset rotatedPairs[numberOfVertices];
+    struct pathEndSearch search = {.adjacencyList = adjacencyList,
+     .unresolvedPairs = unresolvedPairs, .rotatedPairs = rotatedPairs,
+     .pathEnds = pathEnds, .numberOfUnresolvedPairs = 0, .anyPairFlag =
+     anyPairFlag, .done = false};
+    for(int i = 0; i < numberOfVertices; i++) {
+        pathEnds[i] = EMPTY;
+        unresolvedPairs[i] = EMPTY;
+        rotatedPairs[i] = EMPTY;
+    }
+
+    //  Pairs with an excluded vertex have no path and are not searched.
+    bool allPairsFound = true;
+    bitset starts = EMPTY;
+    for(int vertex = 0; vertex < numberOfVertices; vertex++) {
+        bitset requestedEnds = difference(requestedPairs[vertex],
+         singleton(vertex));
+        bitset ends = contains(includedVertices, vertex) ?
+         intersection(requestedEnds, includedVertices) : EMPTY;
+        allPairsFound &= equals(ends, requestedEnds);
+        if(!isEmpty(ends)) {
+            add(starts, vertex);
+        }
+        forEach(end, ends) {
+            add(unresolvedPairs[vertex], end);
+            add(unresolvedPairs[end], vertex);
+        }
+    }
+
+    forEach(vertex, includedVertices) {
+        search.numberOfUnresolvedPairs += size(unresolvedPairs[vertex]);
+    }
+    search.numberOfUnresolvedPairs /= 2;
+
+    //  The pairs are searched from the vertex at which they were requested,
+    //  after which those of the vertex which are still unresolved have no
+    //  path.
+    forEach(start, starts) {
+        if(search.done || searchStopped()) {
+            break;
+        }
+        if(useHeldKarp(numberOfVertices)) {
+            if(isEmpty(unresolvedPairs[start])) {
+                continue;
+            }
+            struct heldKarpTable *table = getHeldKarpTable(adjacencyList,
+             numberOfVertices, start);
+            if(table == NULL) {
+                break;
+            }
+            uint32_t reachableEnds = table->reachableEnds[heldKarpIndex(
+             toMask(includedVertices), start)];
+            forEach(end, unresolvedPairs[start]) {
+                if(!search.done && (reachableEnds & ((uint32_t) 1 << end))) {
+                    addPathEnds(&search, start, end);
+                }
+            }
+        }
+        else {
+            forEach(end, unresolvedPairs[start]) {
+                if(search.done || searchStopped()) {
+                    break;
+                }
+                searchPathEnds(&search, numberOfVertices, includedVertices,
+                 start, end);
+            }
+        }
+        if(search.done || searchStopped()) {
+            break;
+        }
+        forEach(end, unresolvedPairs[start]) {
+            removeElement(unresolvedPairs[end], start);
+            search.numberOfUnresolvedPairs--;
+            allPairsFound = false;
+        }
+        unresolvedPairs[start] = EMPTY;
+    }
+    if(anyPairFlag) {
+        forEach(vertex, includedVertices) {
+            if(!isEmpty(pathEnds[vertex])) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return allPairsFound && search.numberOfUnresolvedPairs == 0;
+}
+
+//  Returns the number of options a vertex which is not in the first path
+//  needs: two, unless it is an end of the second path, which needs one, or
+//  the whole second path, which needs none.
+static int neededOptions(int vertex, int firstElemOfPath2, int
+lastElemOfPath2) {
+    if(vertex != firstElemOfPath2 && vertex != lastElemOfPath2) {
+        return 2;
+    }
+    return firstElemOfPath2 != lastElemOfPath2;
+}
+
+//  The vertices which can be neighbours of a vertex not in the first path in
+//  either path: those not in the first path, the ends of the first path and
+//  the ends of the second path. The ends of the second path are added
+//  separately, since they can be excluded vertices, which are not in
+//  remainingVertices.
+static bitset spanningPathOptionVertices(bitset remainingVertices, int
+lastElemOfPath, int firstElemOfPath, int firstElemOfPath2, int
+lastElemOfPath2) {
+    return union(union(remainingVertices, union(singleton(firstElemOfPath),
+     singleton(lastElemOfPath))), union(singleton(firstElemOfPath2),
+     singleton(lastElemOfPath2)));
+}
+
+//  Every vertex which is not in the first path ends up inside the first path
+//  or in the second path. Its neighbours there are among the vertices of
+//  spanningPathOptionVertices, so the options of counts, which are these
+//  neighbours, have to suffice. Counts the options from scratch and returns
+//  whether they do.
+static bool countSpanningPathOptions(struct optionCounts *counts, bitset
+adjacencyList[], bitset remainingVertices, int lastElemOfPath, int
+firstElemOfPath, int firstElemOfPath2, int lastElemOfPath2) {
+    bitset remainingWithFirstAndLast = spanningPathOptionVertices(
+     remainingVertices, lastElemOfPath, firstElemOfPath, firstElemOfPath2,
+     lastElemOfPath2);
+    bool hasOptions = true;
+    forEach(vertex, remainingWithFirstAndLast) {
+        counts->options[vertex] = size(intersection(adjacencyList[vertex],
+         remainingWithFirstAndLast));
+        if(contains(remainingVertices, vertex) && counts->options[vertex] <
+         neededOptions(vertex, firstElemOfPath2, lastElemOfPath2)) {
+            hasOptions = false;
+        }
+    }
+    return hasOptions;
+}
+
+//  Updates the options after the first path was extended from previousLast
+//  to lastElemOfPath and returns whether they still suffice. Only the
+//  neighbours of previousLast lost an option.
+static bool extendSpanningPathOptions(struct optionCounts *counts, bitset
+adjacencyList[], bitset remainingVertices, int previousLast, int
+lastElemOfPath, int firstElemOfPath, int firstElemOfPath2, int
+lastElemOfPath2) {
+    bitset neighbours = intersection(adjacencyList[previousLast],
+     spanningPathOptionVertices(remainingVertices, lastElemOfPath,
+     firstElemOfPath, firstElemOfPath2, lastElemOfPath2));
+    bool hasOptions = true;
+    forEach(vertex, neighbours) {
+        counts->options[vertex]--;
+        if(contains(remainingVertices, vertex) && counts->options[vertex] <
+         neededOptions(vertex, firstElemOfPath2, lastElemOfPath2)) {
+            hasOptions = false;
+        }
+    }
+    return hasOptions;
+}
+
+//  Undoes extendSpanningPathOptions with the same arguments.
+static void retractSpanningPathOptions(struct optionCounts *counts, bitset
+adjacencyList[], bitset remainingVertices, int previousLast, int
+lastElemOfPath, int firstElemOfPath, int firstElemOfPath2, int
+lastElemOfPath2) {
+    forEach(vertex, intersection(adjacencyList[previousLast],
+     spanningPathOptionVertices(remainingVertices, lastElemOfPath,
+     firstElemOfPath, firstElemOfPath2, lastElemOfPath2))) {
+        counts->options[vertex]++;
+    }
+}
+
+//  The search of isPartOfDisjointSpanningPaths, where counts are the options
+//  of the vertices for the first path and hasOptions is whether they
+//  suffice.
+static bool isPartOfDisjointSpanningPathsWithCounts(struct optionCounts
+*counts, bool hasOptions, bitset adjacencyList[], bitset currentPath, bitset
+excludedVertices, int pathList[], int firstElemOfPath, int lastElemOfPath,
+bitset verticesContainedByPath1, int numberOfVertices, int firstElemOfPath2,
+int lastElemOfPath2, bitset verticesContainedByPath2, int* nOfSpanningPaths,
+bool allCyclesFlag, bool verboseFlag)  { 
+    countPruneEvent(SEARCH_NODE, size(currentPath));
+
+    //  Neither closing the first path nor extending it can give a vertex
+    //  which lacks options a new one.
+    if(!hasOptions) {
+        countPruneEvent(TOO_FEW_OPTIONS, size(currentPath));
+        return (*nOfSpanningPaths);
+    }
 
     //  Check for second path if first path is a cycle and contains
     //  all required vertices.
     if(contains(adjacencyList[lastElemOfPath], firstElemOfPath) &&
      equals(intersection(currentPath, verticesContainedByPath1), verticesContainedByPath1)) {
+        countPruneEvent(FIRST_PATH_CLOSED, size(currentPath));
 
         //  Included vertices which do not belong to the first path
         //  and which are not the endpoints of the second path.
@@ -452,6 +3207,7 @@ nOfSpanningPaths, bool allCyclesFlag, bool verboseFlag)  {
              secondPath, lastElemOfPath2, firstElemOfPath2,
              size(remainingVertices)+2, 2, &nOfPaths, allCyclesFlag,
              verboseFlag)) {
+                countPruneEvent(SECOND_PATH_FOUND, size(currentPath));
                 (*nOfSpanningPaths) += nOfPaths;
                 if(verboseFlag) {fprintf(stderr,"Second path: ");
                     for(int i = 1; i < size(currentPath); i++) {
@@ -472,6 +3228,7 @@ nOfSpanningPaths, bool allCyclesFlag, bool verboseFlag)  {
             if(canBeHamiltonian(adjacencyList, remainingVertices,
              lastElemOfPath2, firstElemOfPath2,
              size(remainingVertices)+2, 2)) {
+                countPruneEvent(SECOND_PATH_FOUND, size(currentPath));
                 return true;
             }
         }
@@ -483,23 +3240,51 @@ nOfSpanningPaths, bool allCyclesFlag, bool verboseFlag)  {
     bitset remainingNeighboursOfLast = difference(adjacencyList[lastElemOfPath],
      union(excludedVertices,union(currentPath, union(verticesContainedByPath2,
      union(singleton(firstElemOfPath2), singleton(lastElemOfPath2))))));
+    bitset remainingVertices = complement(union(currentPath,
+     excludedVertices), numberOfVertices + size(excludedVertices));
     forEach(neighbour, remainingNeighboursOfLast) {
         pathList[size(currentPath)] = neighbour;
         add(currentPath, neighbour);
-        if(isPartOfDisjointSpanningPaths(adjacencyList, currentPath, 
-         excludedVertices, pathList, firstElemOfPath, neighbour, 
-         verticesContainedByPath1, numberOfVertices, firstElemOfPath2,
-         lastElemOfPath2, verticesContainedByPath2, nOfSpanningPaths,
-         allCyclesFlag, verboseFlag)) {
+        removeElement(remainingVertices, neighbour);
+        bool extensionHasOptions = extendSpanningPathOptions(counts,
+         adjacencyList, remainingVertices, lastElemOfPath, neighbour,
+         firstElemOfPath, firstElemOfPath2, lastElemOfPath2);
+        if(isPartOfDisjointSpanningPathsWithCounts(counts,
+         extensionHasOptions, adjacencyList, currentPath, excludedVertices,
+         pathList, firstElemOfPath, neighbour, verticesContainedByPath1,
+         numberOfVertices, firstElemOfPath2, lastElemOfPath2,
+         verticesContainedByPath2, nOfSpanningPaths, allCyclesFlag,
+         verboseFlag)) {
             if(!allCyclesFlag) {
                 return true;
             }
         }
+        retractSpanningPathOptions(counts, adjacencyList, remainingVertices,
+         lastElemOfPath, neighbour, firstElemOfPath, firstElemOfPath2,
+         lastElemOfPath2);
+        add(remainingVertices, neighbour);
         removeElement(currentPath, neighbour);
     }
     return (*nOfSpanningPaths);
 };
 
+bool isPartOfDisjointSpanningPaths(bitset adjacencyList[], bitset currentPath,
+bitset excludedVertices, int pathList[], int firstElemOfPath, int
+lastElemOfPath, bitset verticesContainedByPath1, int numberOfVertices, int
+firstElemOfPath2, int lastElemOfPath2, bitset verticesContainedByPath2, int*
+nOfSpanningPaths, bool allCyclesFlag, bool verboseFlag)  { 
+    struct optionCounts counts;
+    bool hasOptions = countSpanningPathOptions(&counts, adjacencyList,
+     complement(union(currentPath, excludedVertices), numberOfVertices +
+     size(excludedVertices)), lastElemOfPath, firstElemOfPath,
+     firstElemOfPath2, lastElemOfPath2);
+    return isPartOfDisjointSpanningPathsWithCounts(&counts, hasOptions,
+     adjacencyList, currentPath, excludedVertices, pathList, firstElemOfPath,
+     lastElemOfPath, verticesContainedByPath1, numberOfVertices,
+     firstElemOfPath2, lastElemOfPath2, verticesContainedByPath2,
+     nOfSpanningPaths, allCyclesFlag, verboseFlag);
+}
+
 
 bool containsDisjointSpanningPathsWithEnds(bitset adjacencyList[], int
 numberOfVertices, bitset excludedVertices, int startOfPath1, int endOfPath1,
@@ -533,6 +3318,37 @@ verticesContainedByPath2, bool allCyclesFlag, bool verboseFlag) {
 bool isTraceable(bitset adjacencyList[], int numberOfVertices, bitset
 excludedVertices, bool allCyclesFlag, bool verboseFlag) {
     long long unsigned nOfPaths = 0;
+
+    //  The hamiltonian paths of the (sub)graph correspond to the hamiltonian
+    //  cycles of the graph obtained by adding a vertex adjacent to all
+    //  included vertices. This replaces a search for every pair of ends by a
+    //  single search. The paths are only printed and counted per pair of
+    //  ends.
+    if(!verboseFlag && !allCyclesFlag && numberOfVertices < MAXVERTICES) {
+        int universalVertex = numberOfVertices;
+        bitset includedVertices = complement(excludedVertices,
+         numberOfVertices);
+
+        //  In the widened graph every vertex has the extra vertex as an
+        //  option, which weakens the degree pruning. A traceable (sub)graph
+        //  usually has a path which rotations find much faster.
+        if(!isEmpty(includedVertices) && findCycleByRotations(adjacencyList,
+         includedVertices, TRACEABILITYROTATIONS * size(includedVertices),
+         true)) {
+            return true;
+        }
+        bitset widenedAdjacencyList[numberOfVertices + 1];
+        for(int i = 0; i < numberOfVertices; i++) {
+            widenedAdjacencyList[i] = adjacencyList[i];
+        }
+        forEach(vertex, includedVertices) {
+            add(widenedAdjacencyList[vertex], universalVertex);
+        }
+        widenedAdjacencyList[universalVertex] = includedVertices;
+        return isHamiltonian(widenedAdjacencyList, numberOfVertices + 1,
+         excludedVertices, false, false);
+    }
+
     for(int i = 0; i < numberOfVertices; i++) {
         for(int j = i + 1; j < numberOfVertices; j++) {
             int nOfPathsWithEnds;
@@ -555,13 +3371,24 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag) {
 bool isK1Traceable(bitset adjacencyList[], int numberOfVertices, bool
 allCyclesFlag, bool verboseFlag, int vertexToCheck) {
 
+    bitset vertices = verticesToDelete(adjacencyList, numberOfVertices,
+     !verboseFlag);
+
+    if(!verboseFlag && searchSettings.subgraphThreads > 1) {
+        bitset vertexDeletions[numberOfVertices];
+        int numberOfDeletions = listVertexDeletions(vertices,
+         vertexDeletions);
+        return allSubgraphsSatisfy(adjacencyList, numberOfVertices,
+         vertexDeletions, numberOfDeletions, subgraphIsTraceable);
+    }
+
     //  An exceptional vertex is one for which the vertex-deleted subgraph is
     //  non-traceable. 
     bitset exceptionalVertices = EMPTY;
 
     //  Loop over all vertices and determine whether the vertex-deleted
     //  subgraph is traceable.
-    for (int i = 0; i < numberOfVertices; i++) {
+    forEach(i, vertices) {
         bitset excludedVertices = singleton(i);
         if(!verboseFlag) {
             if(!(isTraceable(adjacencyList,numberOfVertices,excludedVertices,
@@ -606,3 +3433,450 @@ allCyclesFlag, bool verboseFlag, int vertexToCheck) {
     //  Zero if there are exceptional vertices, non-zero otherwise.
     return !nOfExceptionalVertices;
 }
+
+bool isK2Traceable(bitset adjacencyList[], int numberOfVertices, bool
+allCyclesFlag, bool verboseFlag, int vertexPairToCheck[]) {
+
+    //  Graphs without edges are not considered to be K2-traceable.
+    if(countEdges(adjacencyList, numberOfVertices) == 0) {
+        if(verboseFlag) {
+            fprintf(stderr, "Graph does not have any edges.\n");
+        }
+        return false;
+    }
+
+    //  Graphs with more than 4 vertices and minimum degree < 2 cannot be
+    //  K2-traceable, since some G - v - w contains an isolated vertex and at
+    //  least two other vertices.
+    if(numberOfVertices > 4 &&
+     !hasMinimumDegree(adjacencyList,numberOfVertices,2)) {
+        if(verboseFlag) {
+            fprintf(stderr, "Graph does not have minimum degree 2.\n");
+        }
+        return false;
+    }
+
+    //  Every G - v - w is checked with a single cycle search in the graph
+    //  widened by a universal vertex (see isTraceable). Since all these
+    //  searches belong to the same graph, they share the transposition table
+    //  and witness cycles.
+    bitset edges[numberOfVertices];
+    edgesToDelete(adjacencyList, numberOfVertices, !verboseFlag, edges);
+
+    if(!verboseFlag && searchSettings.subgraphThreads > 1) {
+        bitset edgeDeletions[countEdges(adjacencyList, numberOfVertices)];
+        int numberOfEdges = listEdgeDeletions(edges, numberOfVertices,
+         edgeDeletions);
+        return allSubgraphsSatisfy(adjacencyList, numberOfVertices,
+         edgeDeletions, numberOfEdges, subgraphIsTraceable);
+    }
+
+    // Pairs (v,w) for which G - v - w is not traceable.
+    bitset exceptionalPairs[numberOfVertices];
+    if(verboseFlag) {
+        for(int i = 0; i < numberOfVertices; i++) {
+            exceptionalPairs[i] = EMPTY;
+        }
+    }
+    bool encounteredNonTraceableSubgraph = false;
+
+    //  Loop over all edges vw with v < w and check if G - v - w is
+    //  traceable.
+    for (int i = 0; i < numberOfVertices; i++) {
+        bitset excludedVertices = singleton(i);
+        forEach(neighbour, edges[i]) {
+            add(excludedVertices, neighbour);
+            if(!verboseFlag) {
+                if(!(isTraceable(adjacencyList, numberOfVertices,
+                 excludedVertices, false, false))){
+                    return false;
+                }
+                removeElement(excludedVertices, neighbour);
+                continue;
+            }
+
+            //  Gets executed if -v is present.
+            bool verbose = false;
+            bool cycles = false;
+
+            //  vertexPairToCheck is determined by -v#,#
+            if((i == vertexPairToCheck[0] && neighbour == vertexPairToCheck[1]) ||
+             (i == vertexPairToCheck[1] && neighbour == vertexPairToCheck[0])) {
+                verbose = true;
+                cycles = allCyclesFlag;
+                fprintf(stderr, "Looking at G - %d - %d.\n",
+                 vertexPairToCheck[0], vertexPairToCheck[1]);
+            }
+            if(!(isTraceable(adjacencyList, numberOfVertices,
+             excludedVertices, cycles, verbose))){
+                add(exceptionalPairs[i], neighbour);
+                encounteredNonTraceableSubgraph = true;
+            }
+            removeElement(excludedVertices, neighbour);
+        }
+    }
+
+    if(verboseFlag) {
+        if(encounteredNonTraceableSubgraph) {
+            fprintf(stderr, "G - v - w is not traceable for (v,w) in {");
+            for (int v = 0; v < numberOfVertices; v++) {
+                forEachAfterIndex(w, exceptionalPairs[v], v) {
+                    fprintf(stderr, "(%d,%d), ",v,w);
+                }
+            }
+            fprintf(stderr, "\b\b}\n");
+        }
+        else {
+            fprintf(stderr, "Graph is K2-traceable.\n");
+        }
+    }
+    return !encounteredNonTraceableSubgraph;
+}
+
+void initialiseSearchConstraints(struct searchConstraints *constraints,
+bitset excludedVertices) {
+    constraints->excludedVertices = excludedVertices;
+    for(int i = 0; i < MAXVERTICES; i++) {
+        constraints->forbiddenEdges[i] = EMPTY;
+        constraints->requiredEdges[i] = EMPTY;
+    }
+}
+
+void forbidEdge(struct searchConstraints *constraints, int u, int v) {
+    add(constraints->forbiddenEdges[u], v);
+    add(constraints->forbiddenEdges[v], u);
+}
+
+void requireEdge(struct searchConstraints *constraints, int u, int v) {
+    add(constraints->requiredEdges[u], v);
+    add(constraints->requiredEdges[v], u);
+}
+
+void requirePath(struct searchConstraints *constraints, int path[], int
+length) {
+    for(int i = 0; i + 1 < length; i++) {
+        requireEdge(constraints, path[i], path[i + 1]);
+    }
+}
+
+//  A graph of which the adjacency list encodes the constraints, so that the
+//  searches without constraints find what satisfies them.
+struct constrainedGraph {
+    bitset adjacencyList[MAXVERTICES];
+    int numberOfVertices;
+};
+
+//  Whether constrainGraph encoded the constraints, found that they cannot be
+//  satisfied or had no room for the new vertices of the required edges.
+enum constraintEncoding {CONSTRAINTS_ENCODED, CONSTRAINTS_UNSATISFIABLE,
+ CONSTRAINTS_TOO_LARGE};
+
+//  Encodes the constraints in graph for a hamiltonian cycle or spanning
+//  paths of which ends are the endpoints.
+static enum constraintEncoding constrainGraph(struct constrainedGraph
+*graph, bitset adjacencyList[], int numberOfVertices, struct
+searchConstraints *constraints, bitset ends) {
+    bitset includedVertices = complement(constraints->excludedVertices,
+     numberOfVertices);
+    graph->numberOfVertices = numberOfVertices;
+    for(int i = 0; i < numberOfVertices; i++) {
+        graph->adjacencyList[i] = difference(adjacencyList[i],
+         constraints->forbiddenEdges[i]);
+    }
+
+    //  A vertex which needs all its required edges has no other options.
+    bitset *requiredEdges = constraints->requiredEdges;
+    bitset saturatedVertices = EMPTY;
+    forEach(vertex, includedVertices) {
+        int neededEdges = contains(ends, vertex) ? 1 : 2;
+        if(size(requiredEdges[vertex]) > neededEdges ||
+         !isEmpty(difference(requiredEdges[vertex],
+         intersection(graph->adjacencyList[vertex], includedVertices)))) {
+            return CONSTRAINTS_UNSATISFIABLE;
+        }
+        if(size(requiredEdges[vertex]) == neededEdges) {
+            add(saturatedVertices, vertex);
+        }
+    }
+    forEach(vertex, saturatedVertices) {
+        forEach(neighbour, difference(graph->adjacencyList[vertex],
+         requiredEdges[vertex])) {
+            removeElement(graph->adjacencyList[neighbour], vertex);
+        }
+        graph->adjacencyList[vertex] = requiredEdges[vertex];
+    }
+
+    //  A required edge between vertices which still have other options is
+    //  replaced by a path over a new vertex, of which both edges are forced.
+    forEach(vertex, difference(includedVertices, saturatedVertices)) {
+        forEachAfterIndex(neighbour, difference(requiredEdges[vertex],
+         saturatedVertices), vertex) {
+            if(graph->numberOfVertices == MAXVERTICES) {
+                return CONSTRAINTS_TOO_LARGE;
+            }
+            int middle = graph->numberOfVertices++;
+            graph->adjacencyList[middle] = union(singleton(vertex),
+             singleton(neighbour));
+            removeElement(graph->adjacencyList[vertex], neighbour);
+            add(graph->adjacencyList[vertex], middle);
+            removeElement(graph->adjacencyList[neighbour], vertex);
+            add(graph->adjacencyList[neighbour], middle);
+        }
+    }
+    return CONSTRAINTS_ENCODED;
+}
+
+//  A search for the paths of containsHamiltonianPathWithConstraints and
+//  containsDisjointSpanningPathsWithConstraints which checks the required
+//  edges itself, for when constrainGraph has no room for their new vertices.
+//  It searches a path from startOfPath1 over all included vertices to
+//  endOfPath2, which for disjoint paths jumps from endOfPath1 to
+//  startOfPath2. For a single path, startOfPath2 is -1 and endOfPath1 is
+//  endOfPath2.
+struct unencodedSearch {
+    bitset adjacencyList[MAXVERTICES];
+    bitset *requiredEdges;
+    int pathList[MAXVERTICES];
+    int numberOfVertices;
+    int endOfPath1;
+    int startOfPath2;
+    int endOfPath2;
+    bitset verticesContainedByPath1;
+    bitset verticesContainedByPath2;
+    int numberOfPaths;
+    bool allCyclesFlag;
+    bool verboseFlag;
+};
+
+static void initialiseUnencodedSearch(struct unencodedSearch *search, bitset
+adjacencyList[], int numberOfVertices, struct searchConstraints
+*constraints, bool allCyclesFlag, bool verboseFlag) {
+    bitset includedVertices = complement(constraints->excludedVertices,
+     numberOfVertices);
+    for(int i = 0; i < numberOfVertices; i++) {
+        search->adjacencyList[i] = intersection(difference(adjacencyList[i],
+         constraints->forbiddenEdges[i]), includedVertices);
+    }
+    search->requiredEdges = constraints->requiredEdges;
+    search->numberOfVertices = size(includedVertices);
+    search->startOfPath2 = -1;
+    search->verticesContainedByPath1 = EMPTY;
+    search->verticesContainedByPath2 = EMPTY;
+    search->numberOfPaths = 0;
+    search->allCyclesFlag = allCyclesFlag;
+    search->verboseFlag = verboseFlag;
+}
+
+static void printUnencodedPaths(struct unencodedSearch *search) {
+    fprintf(stderr, "Path: ");
+    for(int i = 0; i < search->numberOfVertices; i++) {
+        fprintf(stderr, "%d", search->pathList[i]);
+        if(i + 1 == search->numberOfVertices) {
+            fprintf(stderr, "\n");
+        }
+        else if(search->pathList[i] == search->endOfPath1) {
+            fprintf(stderr, "\nSecond path: ");
+        }
+        else {
+            fprintf(stderr, " -> ");
+        }
+    }
+}
+
+//  Extends the path of which the pathLength vertices are in path, where
+//  segmentStart is the position at which the current path started. Returns
+//  true if the search is done.
+static bool extendUnencodedPath(struct unencodedSearch *search, bitset path,
+int pathLength, int segmentStart) {
+    if(searchStopped()) {
+        return true;
+    }
+    countSearchNode();
+    int last = search->pathList[pathLength - 1];
+    bitset predecessor = pathLength - 1 > segmentStart ?
+     singleton(search->pathList[pathLength - 2]) : EMPTY;
+
+    //  The end of a path has no other required edges than its one in the
+    //  path.
+    if(last == search->endOfPath1 || last == search->endOfPath2) {
+        if(!isEmpty(difference(search->requiredEdges[last], predecessor))) {
+            return false;
+        }
+    }
+    if(last == search->endOfPath2) {
+        if(pathLength < search->numberOfVertices) {
+            return false;
+        }
+        search->numberOfPaths++;
+        if(search->verboseFlag) {
+            printUnencodedPaths(search);
+        }
+        return !search->allCyclesFlag;
+    }
+    if(last == search->endOfPath1) {
+        if(!isEmpty(difference(search->verticesContainedByPath1, path)) ||
+         !isEmpty(intersection(search->requiredEdges[search->startOfPath2],
+         path))) {
+            return false;
+        }
+        search->pathList[pathLength] = search->startOfPath2;
+        return extendUnencodedPath(search, union(path,
+         singleton(search->startOfPath2)), pathLength + 1, pathLength);
+    }
+
+    //  The vertices of the second path do not belong to the first one, and
+    //  its start is only reached from the end of the first one.
+    bitset unavailableVertices = path;
+    if(search->startOfPath2 >= 0) {
+        add(unavailableVertices, search->startOfPath2);
+        if(segmentStart == 0) {
+            unavailableVertices = union(unavailableVertices,
+             search->verticesContainedByPath2);
+        }
+    }
+    if(pathLength + 1 < search->numberOfVertices) {
+        add(unavailableVertices, search->endOfPath2);
+    }
+    forEach(neighbour, difference(search->adjacencyList[last],
+     unavailableVertices)) {
+
+        //  Last cannot leave out one of its required edges and neighbour
+        //  cannot have one to a vertex of which the edges are known.
+        if(!isEmpty(difference(search->requiredEdges[last],
+         union(predecessor, singleton(neighbour)))) ||
+         !isEmpty(difference(intersection(search->requiredEdges[neighbour],
+         path), singleton(last)))) {
+            continue;
+        }
+        search->pathList[pathLength] = neighbour;
+        if(extendUnencodedPath(search, union(path, singleton(neighbour)),
+         pathLength + 1, segmentStart)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isHamiltonianWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, bool allCyclesFlag,
+bool verboseFlag) {
+    bitset includedVertices = complement(constraints->excludedVertices,
+     numberOfVertices);
+
+    //  The path search closes the path between its ends to a cycle, so it
+    //  searches the cycles through the edge between them.
+    forEach(vertex, includedVertices) {
+        if(isEmpty(constraints->requiredEdges[vertex])) {
+            continue;
+        }
+        int neighbour = next(constraints->requiredEdges[vertex], -1);
+        if(!contains(includedVertices, neighbour) ||
+         !contains(adjacencyList[vertex], neighbour) ||
+         contains(constraints->forbiddenEdges[vertex], neighbour)) {
+            return false;
+        }
+        struct searchConstraints pathConstraints = *constraints;
+        removeElement(pathConstraints.requiredEdges[vertex], neighbour);
+        removeElement(pathConstraints.requiredEdges[neighbour], vertex);
+        return containsHamiltonianPathWithConstraints(adjacencyList,
+         numberOfVertices, &pathConstraints, vertex, neighbour,
+         allCyclesFlag, verboseFlag);
+    }
+
+    //  Without required edges there are no new vertices, so the constraints
+    //  always fit.
+    struct constrainedGraph graph;
+    if(constrainGraph(&graph, adjacencyList, numberOfVertices, constraints,
+     EMPTY) != CONSTRAINTS_ENCODED) {
+        return false;
+    }
+
+    //  The transposition table and the kept cycles of the graph do not apply
+    //  to the constrained graph.
+    unsigned long long int graphNumber = searchControl.graphNumber;
+    searchControl.graphNumber = 0;
+    bool hamiltonian = isHamiltonian(graph.adjacencyList,
+     graph.numberOfVertices, constraints->excludedVertices, allCyclesFlag,
+     verboseFlag);
+    searchControl.graphNumber = graphNumber;
+    return hamiltonian;
+}
+
+int containsHamiltonianPathWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, int start, int end,
+bool allCyclesFlag, bool verboseFlag) {
+    struct constrainedGraph graph;
+    bitset ends = union(singleton(start), singleton(end));
+    enum constraintEncoding encoding = constrainGraph(&graph, adjacencyList,
+     numberOfVertices, constraints, ends);
+    if(encoding == CONSTRAINTS_UNSATISFIABLE) {
+        return false;
+    }
+
+    if(encoding == CONSTRAINTS_TOO_LARGE) {
+        struct unencodedSearch search;
+        initialiseUnencodedSearch(&search, adjacencyList, numberOfVertices,
+         constraints, allCyclesFlag, verboseFlag);
+        search.endOfPath1 = end;
+        search.endOfPath2 = end;
+        search.pathList[0] = start;
+        extendUnencodedPath(&search, singleton(start), 1, 0);
+        if(allCyclesFlag) {
+            fprintf(stderr,"There were %d hamiltonian (%d,%d)-paths in this graph.\n\n",
+             search.numberOfPaths, start, end);
+        }
+        return search.numberOfPaths;
+    }
+    unsigned long long int graphNumber = searchControl.graphNumber;
+    searchControl.graphNumber = 0;
+    int result = containsHamiltonianPathWithEnds(graph.adjacencyList,
+     graph.numberOfVertices, constraints->excludedVertices, start, end,
+     allCyclesFlag, verboseFlag);
+    searchControl.graphNumber = graphNumber;
+    return result;
+}
+
+bool containsDisjointSpanningPathsWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, int startOfPath1,
+int endOfPath1, bitset verticesContainedByPath1, int startOfPath2, int
+endOfPath2, bitset verticesContainedByPath2, bool allCyclesFlag, bool
+verboseFlag) {
+    struct constrainedGraph graph;
+    bitset ends = union(union(singleton(startOfPath1), singleton(endOfPath1)),
+     union(singleton(startOfPath2), singleton(endOfPath2)));
+    enum constraintEncoding encoding = constrainGraph(&graph, adjacencyList,
+     numberOfVertices, constraints, ends);
+    if(encoding == CONSTRAINTS_UNSATISFIABLE) {
+        return false;
+    }
+
+    if(encoding == CONSTRAINTS_TOO_LARGE) {
+        struct unencodedSearch search;
+        initialiseUnencodedSearch(&search, adjacencyList, numberOfVertices,
+         constraints, allCyclesFlag, verboseFlag);
+        search.endOfPath1 = endOfPath1;
+        search.startOfPath2 = startOfPath2;
+        search.endOfPath2 = endOfPath2;
+        search.verticesContainedByPath1 = verticesContainedByPath1;
+        search.verticesContainedByPath2 = verticesContainedByPath2;
+        search.pathList[0] = startOfPath1;
+        extendUnencodedPath(&search, singleton(startOfPath1), 1, 0);
+        if(allCyclesFlag) {
+            fprintf(stderr, "Graph contains %d pairs of disjoint spanning paths between (%d,%d)%s and (%d,%d)%s.\n",
+             search.numberOfPaths, startOfPath1, endOfPath1,
+             isEmpty(verticesContainedByPath1) ? "" : " containing specified vertices",
+             startOfPath2, endOfPath2,
+             isEmpty(verticesContainedByPath1) ? "" : " containing specified vertices");
+        }
+        return search.numberOfPaths;
+    }
+    unsigned long long int graphNumber = searchControl.graphNumber;
+    searchControl.graphNumber = 0;
+    bool contained = containsDisjointSpanningPathsWithEnds(
+     graph.adjacencyList, graph.numberOfVertices,
+     constraints->excludedVertices, startOfPath1, endOfPath1,
+     verticesContainedByPath1, startOfPath2, endOfPath2,
+     verticesContainedByPath2, allCyclesFlag, verboseFlag);
+    searchControl.graphNumber = graphNumber;
+    return contained;
+}
@@ -6,8 +6,380 @@
 #ifndef HAM_METHODS 
 #define HAM_METHODS
 
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
 #include "bitset.h"
 
+//  The largest order for which the Held-Karp engine can be used.
+#define HELDKARPMAXORDER 26
+
+/**
+ *  The search engines for which pruning can be configured separately.
+ *  CYCLE_SEARCH is canBeHamiltonian and PRINT_CYCLE_SEARCH is
+ *  canBeHamiltonianPrintCycle.
+ * */
+enum searchEngine {CYCLE_SEARCH, PRINT_CYCLE_SEARCH, NUMBER_OF_SEARCH_ENGINES};
+
+/**
+ *  Settings which determine how the methods below perform their searches.
+ *  These are set once by the calling program before any graph is checked.
+ * 
+ *  @param  subgraphThreads The number of threads on which the
+ *   vertex-deleted or edge-deleted subgraphs of a graph are checked in
+ *   isK1Hamiltonian, isK2Hamiltonian, isK1Traceable and isK2Traceable. Only
+ *   used if no verbose output is asked for.
+ *  @param  searchThreads   The number of threads over which the search tree
+ *   of a single hamiltonicity check is divided in isHamiltonian,
+ *   containsHamiltonianPathWithEnds and canBeHamiltonianInParallel. Only used
+ *   if no verbose output is asked for and cycles are not counted.
+ *  @param  forcedEdgePropagation   If true, canBeHamiltonian and
+ *   canBeHamiltonianPrintCycle determine in every step which edges are forced
+ *   because a vertex has only two possible neighbours left in the cycle (or
+ *   an endpoint of the path one). The other edges of vertices with two forced
+ *   edges are dropped, which can force further edges. Paths are cut off as
+ *   soon as the forced edges close a cycle which is not hamiltonian or a
+ *   vertex has too few possible neighbours left.
+ *  @param  bidirectionalExtension  If true, canBeHamiltonian extends the
+ *   path at whichever of its ends has the fewest neighbours not in the path,
+ *   instead of always at its last vertex. A path with only one extension
+ *   left is not counted as a node, since nothing was branched on.
+ *   canBeHamiltonianPrintCycle, which prints the path in order, and the
+ *   shallow levels of the parallel search keep extending the last vertex.
+ *  @param  connectivityCheckInterval   For every engine, the paths of which
+ *   the length is a multiple of this number get cut off if the vertices not
+ *   in the path are disconnected. If it is 0, no such check is performed by
+ *   that engine.
+ *  @param  articulationCheck   If true, the connectivity check also cuts off
+ *   paths for which some vertex separates a part of the remaining vertices
+ *   from both endpoints of the path.
+ *  @param  heldKarpMaxOrder    Graphs with at most this many vertices (and at
+ *   most HELDKARPMAXORDER) are checked by isHamiltonian and
+ *   containsHamiltonianPathWithEnds with a Held-Karp dynamic programming
+ *   engine instead of the search, unless cycles are printed or counted. Per
+ *   start vertex, this engine computes for every set of vertices containing
+ *   it in which vertices a hamiltonian path of that set can end. These tables
+ *   take 2^(n + 1) bytes each and are reused for all subgraphs of the same
+ *   graph. Every thread keeps up to three of them.
+ *  @param  transpositionTableSize  The number of MiB of a hash table, shared
+ *   by all threads, in which canBeHamiltonian stores paths it could not
+ *   extend to a hamiltonian cycle, so that these are not searched again when
+ *   they are reached in a different order. Only paths of the same graph are
+ *   compared, see searchControl.graphNumber. If it is 0, no table is used.
+ *  @param  posaBudget  If this is positive, isHamiltonian first tries to find
+ *   a hamiltonian cycle with at most this many steps of a randomised
+ *   rotation-extension heuristic (Posa), unless cycles are printed or
+ *   counted. The search is only performed if the heuristic fails.
+ *  @param  liftCycles  If true, every thread keeps the last hamiltonian
+ *   cycles found by isHamiltonian in subgraphs of the graph with number
+ *   searchControl.graphNumber. Before searching another subgraph of that
+ *   graph, isHamiltonian tries to turn one of these cycles into a cycle of
+ *   the subgraph by leaving out its excluded vertices and inserting each
+ *   missing vertex between two consecutive neighbours. Unless cycles are
+ *   printed or counted.
+ *  @param  skipSearch  If true and no verbose output is asked for,
+ *   isK1Hamiltonian and isK2Hamiltonian check the subgraphs which do not
+ *   contain some vertex of lowest degree separately, and all other
+ *   vertex-deleted or edge-deleted subgraphs together in a single search for
+ *   cycles which skip one vertex or the ends of one edge. This search stops
+ *   as soon as all these subgraphs were shown to be hamiltonian. Takes
+ *   precedence over subgraphThreads.
+ *  @param  orbitReduction  If true and no verbose output is asked for,
+ *   isK1Hamiltonian, isK2Hamiltonian, isK1Traceable and isK2Traceable compute
+ *   the automorphism group of the graph and only check the subgraphs
+ *   obtained by deleting one vertex or edge of every orbit.
+ *  @param  meetInTheMiddleMemory   If this is positive,
+ *   containsHamiltonianPathWithEnds first tries a meet-in-the-middle engine,
+ *   unless paths are printed or counted or the Held-Karp engine is used. It
+ *   stores all paths from start over half of the vertices in a hash table
+ *   and joins the paths from end over the other vertices with them. The
+ *   table of every thread takes at most this many MiB. Queries which need a
+ *   larger table are answered by the search.
+ * */
+struct searchSettings {
+    int subgraphThreads;
+    int searchThreads;
+    bool forcedEdgePropagation;
+    bool bidirectionalExtension;
+    int connectivityCheckInterval[NUMBER_OF_SEARCH_ENGINES];
+    bool articulationCheck;
+    int heldKarpMaxOrder;
+    int transpositionTableSize;
+    int posaBudget;
+    bool liftCycles;
+    bool skipSearch;
+    bool orbitReduction;
+    int meetInTheMiddleMemory;
+};
+
+extern struct searchSettings searchSettings;
+
+/**
+ *  Counts how often the connectivity check of an engine was performed and
+ *  how often it cut off a path.
+ * 
+ *  @param  checks  The number of performed checks.
+ *  @param  disconnected    The number of paths cut off because the remaining
+ *   vertices were disconnected.
+ *  @param  separated   The number of paths cut off because some vertex
+ *   separated a part of the remaining vertices from both endpoints.
+ * */
+struct connectivityStatistics {
+    atomic_llong checks;
+    atomic_llong disconnected;
+    atomic_llong separated;
+};
+
+extern struct connectivityStatistics
+connectivityStatistics[NUMBER_OF_SEARCH_ENGINES];
+
+/**
+ *  Counts the lookups of canBeHamiltonian in the transposition table.
+ * 
+ *  @param  hits    The number of paths which were found in the table and
+ *   hence not searched again.
+ *  @param  misses  The number of paths which were not found in the table.
+ *  @param  stores  The number of paths which were stored in the table after
+ *   they could not be extended.
+ * */
+struct transpositionStatistics {
+    atomic_llong hits;
+    atomic_llong misses;
+    atomic_llong stores;
+};
+
+extern struct transpositionStatistics transpositionStatistics;
+
+/**
+ *  Counts how often isHamiltonian ran the rotation-extension heuristic and
+ *  how often it found a hamiltonian cycle.
+ * 
+ *  @param  attempts    The number of subgraphs on which it was run.
+ *  @param  successes   The number of subgraphs in which it found a
+ *   hamiltonian cycle, so that no search was needed.
+ * */
+struct posaStatistics {
+    atomic_llong attempts;
+    atomic_llong successes;
+};
+
+extern struct posaStatistics posaStatistics;
+
+/**
+ *  Counts the queries of containsHamiltonianPathWithEnds which the
+ *  meet-in-the-middle engine tried to answer.
+ * 
+ *  @param  queries The number of queries on which it was run.
+ *  @param  fallbacks   The number of these queries for which its table
+ *   would have exceeded searchSettings.meetInTheMiddleMemory, which were
+ *   answered by the search instead.
+ * */
+struct meetInTheMiddleStatistics {
+    atomic_llong queries;
+    atomic_llong fallbacks;
+};
+
+extern struct meetInTheMiddleStatistics meetInTheMiddleStatistics;
+
+/**
+ *  Counts how often isHamiltonian tried to lift a kept cycle to a subgraph
+ *  and how often this succeeded.
+ * 
+ *  @param  attempts    The number of subgraphs for which a kept cycle was
+ *   tried.
+ *  @param  lifted  The number of subgraphs shown to be hamiltonian by lifting
+ *   a kept cycle.
+ * */
+struct witnessStatistics {
+    atomic_llong attempts;
+    atomic_llong lifted;
+};
+
+extern struct witnessStatistics witnessStatistics;
+
+/**
+ *  Counts how many vertex-deleted or edge-deleted subgraphs were not checked
+ *  because they are isomorphic to another subgraph which was checked.
+ * 
+ *  @param  subgraphs   The number of subgraphs of the graphs for which the
+ *   orbits were computed.
+ *  @param  skipped The number of these subgraphs which were not checked.
+ * */
+struct orbitStatistics {
+    atomic_llong subgraphs;
+    atomic_llong skipped;
+};
+
+extern struct orbitStatistics orbitStatistics;
+
+/**
+ *  Counts the work of all searches.
+ * 
+ *  @param  nodes   The number of nodes visited by canBeHamiltonian,
+ *   canBeHamiltonianPrintCycle and the skip search. Every thread adds its
+ *   nodes in batches of BUDGETCHECKINTERVAL, so this lags slightly behind.
+ * */
+struct searchStatistics {
+    atomic_llong nodes;
+};
+
+extern struct searchStatistics searchStatistics;
+
+/**
+ *  The events of the searches which a build with PRUNE_STATISTICS defined
+ *  (make 64bit-stats) counts per path length. Besides the visited nodes,
+ *  these are the reasons why a node of canBeHamiltonian,
+ *  canBeHamiltonianPrintCycle or the parallel search ends: a cycle was
+ *  found, the first vertex has no remaining neighbour to close the cycle,
+ *  a remaining vertex has too few options, the path is in the transposition
+ *  table, the connectivity check failed, the forced edges contradict each
+ *  other or all extensions failed. isPartOfDisjointSpanningPaths counts
+ *  its nodes, the nodes at which a vertex has too few options left for
+ *  either path, the first paths which close with all required vertices and
+ *  the second paths it found.
+ * */
+enum pruneEvent {SEARCH_NODE, CYCLE_FOUND, NOT_CLOSABLE, TOO_FEW_OPTIONS,
+ REFUTED_PATH, CONNECTIVITY_CUT, FORCED_EDGE_CONFLICT, EXTENSIONS_EXHAUSTED,
+ FIRST_PATH_CLOSED, SECOND_PATH_FOUND, NUMBER_OF_PRUNE_EVENTS};
+
+#ifdef PRUNE_STATISTICS
+
+/**
+ *  For every event and path length, how often the event occurred. The
+ *  counters are shared by all threads, which slows down runs on several
+ *  threads.
+ * */
+struct pruneStatistics {
+    atomic_llong counts[NUMBER_OF_PRUNE_EVENTS][MAXVERTICES + 1];
+};
+
+extern struct pruneStatistics pruneStatistics;
+
+#define countPruneEvent(event, pathLength) \
+ atomic_fetch_add_explicit(&pruneStatistics.counts[event][pathLength], 1, \
+ memory_order_relaxed)
+
+/**
+ *  Prints for every path length at which some event occurred how often each
+ *  event occurred, followed by the totals, to stderr.
+ * */
+void printPruneStatistics(void);
+
+#else
+
+//  Compiles to nothing, so that the normal build has no overhead.
+#define countPruneEvent(event, pathLength)
+
+#endif
+
+/**
+ *  Returns the number of search nodes visited by the current thread so far,
+ *  exactly and including the nodes visited on other threads by the searches
+ *  which the current thread started and waited for.
+ * */
+long long int searchNodesOfThread(void);
+
+/**
+ *  The most expensive vertex-deleted or edge-deleted subgraph of a graph.
+ *  Is filled in by isHamiltonian, also when it is called by isTraceable, for
+ *  every subgraph which excludes some vertices.
+ * 
+ *  @param  mutex   Guards the other fields, since the subgraphs can be
+ *   checked on several threads.
+ *  @param  dominatingNodes The number of search nodes visited in the most
+ *   expensive subgraph, as counted by searchNodesOfThread.
+ *  @param  dominatingSubgraph  The vertices excluded from that subgraph.
+ * */
+struct searchCost {
+    pthread_mutex_t mutex;
+    long long int dominatingNodes;
+    bitset dominatingSubgraph;
+};
+
+/**
+ *  Limits on the searches for a single graph. Once one of them is exceeded,
+ *  all searches which use the budget give up as if they were cancelled, so
+ *  the result of the check is meaningless.
+ * 
+ *  @param  maxNodes    The number of search nodes after which the budget is
+ *   exceeded, or 0 if the number of nodes is not limited. The nodes are
+ *   counted in batches of BUDGETCHECKINTERVAL per thread, so the searches
+ *   can overshoot this slightly.
+ *  @param  hasDeadline Whether deadline is used.
+ *  @param  deadline    The time of the CLOCK_MONOTONIC clock after which the
+ *   budget is exceeded.
+ *  @param  nodes   The number of search nodes counted so far.
+ *  @param  exceeded    Set as soon as one of the limits is exceeded.
+ * */
+struct searchBudget {
+    long long int maxNodes;
+    bool hasDeadline;
+    struct timespec deadline;
+    atomic_llong nodes;
+    atomic_bool exceeded;
+};
+
+//  The number of search nodes a thread visits between two checks of the
+//  budget.
+#define BUDGETCHECKINTERVAL 1024
+
+/**
+ *  Initialises budget such that it allows maxNodes search nodes and
+ *  maxSeconds seconds from now. Either of them can be 0 if it should not be
+ *  limited.
+ * */
+void startSearchBudget(struct searchBudget *budget, long long int maxNodes,
+double maxSeconds);
+
+/**
+ *  State of the searches which are running in the current thread.
+ * 
+ *  @param  cancelled   If this is not NULL and the flag it points to is set,
+ *   canBeHamiltonian gives up and returns false. This is used to stop all
+ *   other searches once one of them settled the answer. The result of any
+ *   search during which the flag was set is meaningless.
+ *  @param  parentCancelled Is used like cancelled. The parallel search sets
+ *   it in its workers to the flag of the search which started it, so that
+ *   they also give up as soon as that one is cancelled.
+ *  @param  graphNumber If this is not 0, canBeHamiltonian uses the
+ *   transposition table for the paths of the graph with this number and
+ *   isHamiltonian lifts the cycles it kept for this graph. All
+ *   searches with the same number have to be in the same graph (but may
+ *   exclude different vertices). The searches started by the methods below
+ *   on other threads inherit the number.
+ *  @param  budget  If this is not NULL, canBeHamiltonian,
+ *   canBeHamiltonianPrintCycle and the skip search count their nodes in it
+ *   and give up once it is exceeded. The Held-Karp engine and the rotation
+ *   heuristic do not count nodes, but give up once the deadline passed.
+ *   The searches started by the methods below on other threads inherit the
+ *   budget. Use setSearchBudget to replace it.
+ *  @param  cost    If this is not NULL, isHamiltonian records the most
+ *   expensive subgraph in it. The searches started by the methods below on
+ *   other threads inherit it.
+ * */
+struct searchControl {
+    atomic_bool *cancelled;
+    atomic_bool *parentCancelled;
+    unsigned long long int graphNumber;
+    struct searchBudget *budget;
+    struct searchCost *cost;
+};
+
+extern __thread struct searchControl searchControl;
+
+/**
+ *  Replaces searchControl.budget by budget, after adding the nodes which the
+ *  current thread visited but did not count yet to the old budget. Without
+ *  this, these nodes would be charged to the new budget.
+ * */
+void setSearchBudget(struct searchBudget *budget);
+
+/**
+ *  Returns a number which has not been returned before and can be used as
+ *  searchControl.graphNumber for a new graph.
+ * */
+unsigned long long int newGraphNumber(void);
+
 /**
  *  Returns a boolean indicating whether or not the specified path can be
  *  extended to a hamiltonian cycle in the specified graph. The path is
@@ -33,6 +405,26 @@ bool canBeHamiltonian(bitset adjacencyList[], bitset remainingVertices, int
 lastElemOfPath, int firstElemOfPath, int numberOfVertices, int pathLength);
 
 
+/**
+ *  Same as canBeHamiltonian, but the search tree is split into subtrees at
+ *  shallow depth and these are divided over searchSettings.searchThreads
+ *  threads. Threads which run out of subtrees steal them from the others.
+ *  All threads stop as soon as one of them finds a hamiltonian cycle.
+ * 
+ *  @param  adjacencyList   See canBeHamiltonian.
+ *  @param  remainingVertices   See canBeHamiltonian.
+ *  @param  lastElemOfPath  See canBeHamiltonian.
+ *  @param  firstElemOfPath See canBeHamiltonian.
+ *  @param  numberOfVertices    See canBeHamiltonian.
+ *  @param  pathLength  See canBeHamiltonian.
+ * 
+ *  @return Boolean representing whether the given path can be extended to a
+ *   hamiltonian cycle.
+ * */
+bool canBeHamiltonianInParallel(bitset adjacencyList[], bitset
+remainingVertices, int lastElemOfPath, int firstElemOfPath, int
+numberOfVertices, int pathLength);
+
 /**
  * Similar to the canBeHamiltonian, but specifically for counting and printing
  * cycles/paths. Has slightly worse performance than canBeHamiltonian.
@@ -106,6 +498,28 @@ excludedvertices, bool allCyclesFlag, bool verboseFlag);
  */
 bool hasMinimumDegree(bitset adjacencyList[], int numberOfVertices, int degree);
 
+/**
+ * Returns a boolean indicating whether or not the (sub)graph is k-connected,
+ * i.e. has more than k vertices and stays connected after removing any k - 1
+ * of them. Since every hamiltonian graph is 2-connected and every
+ * K1-hamiltonian graph 3-connected, this is a cheap test before the searches
+ * for hamiltonian cycles.
+ * 
+ * @param   adjacencyList   An array of bitsets representing the adjacency
+ *  list of the given graph.
+ * @param   numberOfVertices    The number of vertices in the graph.
+ * @param   excludedVertices    A bitset representing the vertices we ban from
+ *  our graph. We check the subgraph spanned by all vertices not contained in
+ *  excludedVertices.
+ * @param   k   The connectivity we want to check. Only 1, 2 and 3 are
+ *  supported.
+ * 
+ * @return Returns true when the (sub)graph is k-connected and false
+ *  otherwise.
+ */
+bool isKConnected(bitset adjacencyList[], int numberOfVertices, bitset
+excludedVertices, int k);
+
 /**
  *  Returns a boolean indicating whether the graph is K1-hamiltonian, i.e.
  *  deleting any copy of K1 (a single vertex), yields a hamiltonian graph for
@@ -190,6 +604,39 @@ int containsHamiltonianPathWithEnds(bitset adjacencyList[], int
 numberOfVertices, bitset excludedNodes, int start, int end, bool verboseFlag,
 bool allCyclesFlag);
 
+/**
+ *  Determines for many pairs of endpoints at once between which of them the
+ *  (sub)graph contains a hamiltonian path. The pairs share their searches:
+ *  every hamiltonian path which is found is rotated as in the Posa heuristic,
+ *  which resolves the pairs of ends of all paths reached in this way without
+ *  a search of their own. Only the pairs which are still unresolved after
+ *  this are searched, and the search stops as soon as all pairs are
+ *  resolved. If more than one search thread or the meet-in-the-middle
+ *  engine is used, the searches do not return their paths and every pair is
+ *  searched. Small graphs are resolved with one Held-Karp table per start.
+ * 
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the given graph.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  excludedVertices    A bitset representing the vertices we ban from
+ *   our graph.
+ *  @param  requestedPairs  For every vertex, the vertices with which it forms
+ *   a requested pair of endpoints. It suffices to list a pair at one of its
+ *   vertices, and a vertex paired with itself is ignored.
+ *  @param  anyPairFlag If true, the search already stops at the first pair
+ *   with a hamiltonian path.
+ *  @param  pathEnds    Is set to the matrix of the requested pairs with a
+ *   hamiltonian path found: for every vertex, the vertices with which it
+ *   forms such a pair. Unless anyPairFlag is true, these are all requested
+ *   pairs with a hamiltonian path.
+ * 
+ *  @return If anyPairFlag is true, whether some requested pair has a
+ *   hamiltonian path, and otherwise whether all requested pairs have one.
+ * */
+bool findHamiltonianPathEnds(bitset adjacencyList[], int numberOfVertices,
+bitset excludedVertices, bitset requestedPairs[], bool anyPairFlag, bitset
+pathEnds[]);
+
 /**
  * Returns a boolean indicating whether or not the (sub)graph contains two
  * disjoint paths with specified endpoints and containing specified vertices,
@@ -225,7 +672,11 @@ verticesContainedByPath2, bool allCyclesFlag, bool verboseFlag);
 
 /**
  * Returns a boolean indicating whether or not the (sub)graph is traceable,
- * i.e., contains some hamiltonian path.
+ * i.e., contains some hamiltonian path. Unless paths are printed, this is
+ * done by a single search for a hamiltonian cycle in the graph obtained by
+ * adding a vertex adjacent to all included vertices. If the graph has
+ * MAXVERTICES vertices or paths are printed, every pair of endpoints is
+ * searched separately.
  *  @param  adjacencyList   An array of bitsets representing the adjacency
  *   list of the given graph.
  *  @param  numberOfVertices    The number of vertices in the graph.
@@ -268,4 +719,158 @@ excludedVertices, bool allCyclesFlag, bool verboseFlag);
 bool isK1Traceable(bitset adjacencyList[], int numberOfVertices, bool
 allCyclesFlag, bool verboseFlag, int vertexToCheck);
 
+/**
+ *  Returns a boolean indicating whether the graph is K2-traceable, i.e.
+ *  deleting any copy of K2 (two adjacent vertices), yields a traceable graph.
+ * 
+ *  @param  adjacencyList   Array of bitsets representing the adjacency list
+ *   of the original graph.
+ *  @param  numberOfVertices The number of vertices in the original graph.
+ *  @param  allCyclesFlag   Boolean, which if true and if vertexPairToCheck
+ *   is an edge of the graph counts or prints out all hamiltonian paths in
+ *   G - vertexPairToCheck[0] - vertexPairToCheck[1] depending on the value of
+ *   verboseFlag.
+ *  @param  verboseFlag     Boolean, which if true indicates for which edges
+ *   vw the subgraph G - v - w is non-traceable. If vertexPairToCheck is an
+ *   edge of the graph it prints out (if any exist) a hamiltonian path in
+ *   G - vertexPairToCheck[0] - vertexPairToCheck[1].
+ *  @param  vertexPairToCheck   Array containing two vertices. If these form
+ *   an edge of the graph, a hamiltonian path (if any exist) of the subgraph
+ *   obtained by deleting them will be printed if verboseFlag is true or all
+ *   hamiltonian paths will be printed if allCyclesFlag and verboseFlag are
+ *   true or all hamiltonian paths will be counted if allCyclesFlag is true,
+ *   but verboseFlag is false.
+ * 
+ *  @return True if the graph is K2-traceable, false otherwise.
+ * */
+bool isK2Traceable(bitset adjacencyList[], int numberOfVertices, bool
+allCyclesFlag, bool verboseFlag, int vertexPairToCheck[]);
+
+/**
+ *  Constraints on the hamiltonian cycles or paths which are searched in a
+ *  graph, given as masks next to its adjacency list. The searches with
+ *  constraints never change the adjacency list, so it can be shared by
+ *  threads. Initialise them with initialiseSearchConstraints and add edges
+ *  with forbidEdge, requireEdge and requirePath.
+ * 
+ *  @param  excludedVertices    The vertices which are not in the subgraph
+ *   which is searched.
+ *  @param  forbiddenEdges  For every vertex, its neighbours to which it may
+ *   not be joined in the cycle or paths.
+ *  @param  requiredEdges   For every vertex, its neighbours to which it has
+ *   to be joined in the cycle or paths.
+ * */
+struct searchConstraints {
+    bitset excludedVertices;
+    bitset forbiddenEdges[MAXVERTICES];
+    bitset requiredEdges[MAXVERTICES];
+};
+
+/**
+ *  Initialises constraints such that they exclude excludedVertices and
+ *  neither forbid nor require any edges.
+ * */
+void initialiseSearchConstraints(struct searchConstraints *constraints,
+bitset excludedVertices);
+
+/**
+ *  Forbids the edge between u and v.
+ * */
+void forbidEdge(struct searchConstraints *constraints, int u, int v);
+
+/**
+ *  Requires the edge between u and v.
+ * */
+void requireEdge(struct searchConstraints *constraints, int u, int v);
+
+/**
+ *  Requires all edges of the path given by the length vertices of path.
+ * */
+void requirePath(struct searchConstraints *constraints, int path[], int
+length);
+
+/**
+ *  Same as isHamiltonian, but for the hamiltonian cycles of the subgraph
+ *  which satisfy the constraints.
+ * 
+ *  The constraints are encoded in a copy of the adjacency list, so that all
+ *  pruning of the searches applies to them. A vertex loses its forbidden
+ *  edges, and a vertex which has as many required edges as it has
+ *  neighbours in the cycle loses all its other edges, such that the
+ *  searches find these edges forced. If there is a required edge, the
+ *  cycles through it are searched as the hamiltonian paths between its ends.
+ *  Every other required edge between two vertices which still have other
+ *  edges is subdivided by a new vertex. If paths are printed, these new
+ *  vertices are numbered from numberOfVertices on, and if they are counted,
+ *  so are the paths between the ends of the first required edge. If the
+ *  graph has not enough room for the new vertices, the paths are searched
+ *  without this encoding instead, by a plain search which checks the
+ *  required edges while extending them.
+ * 
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the given graph. It is not changed.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  constraints The constraints the hamiltonian cycles have to
+ *   satisfy.
+ *  @param  allCyclesFlag   See isHamiltonian.
+ *  @param  verboseFlag See isHamiltonian.
+ * 
+ *  @return True if the (sub)graph has a hamiltonian cycle which satisfies
+ *   the constraints.
+ * */
+bool isHamiltonianWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, bool allCyclesFlag,
+bool verboseFlag);
+
+/**
+ *  Same as containsHamiltonianPathWithEnds, but for the hamiltonian paths
+ *  which satisfy the constraints. These are encoded as described at
+ *  isHamiltonianWithConstraints, where start and end have one neighbour in
+ *  the path.
+ * 
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the given graph. It is not changed.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  constraints The constraints the hamiltonian paths have to
+ *   satisfy.
+ *  @param  start   One of the endpoints of the paths.
+ *  @param  end     The other endpoint of the paths.
+ *  @param  allCyclesFlag   See containsHamiltonianPathWithEnds.
+ *  @param  verboseFlag See containsHamiltonianPathWithEnds.
+ * 
+ *  @return Non-zero if there is a hamiltonian path between start and end
+ *   which satisfies the constraints. If allCyclesFlag is true, the number of
+ *   these paths.
+ * */
+int containsHamiltonianPathWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, int start, int end,
+bool allCyclesFlag, bool verboseFlag);
+
+/**
+ *  Same as containsDisjointSpanningPathsWithEnds, but for the pairs of
+ *  paths which satisfy the constraints. These are encoded as described at
+ *  isHamiltonianWithConstraints, where the endpoints of both paths have one
+ *  neighbour in them.
+ * 
+ *  @param  adjacencyList   An array of bitsets representing the adjacency
+ *   list of the given graph. It is not changed.
+ *  @param  numberOfVertices    The number of vertices in the graph.
+ *  @param  constraints The constraints the paths have to satisfy.
+ *  @param  startOfPath1    See containsDisjointSpanningPathsWithEnds.
+ *  @param  endOfPath1  See containsDisjointSpanningPathsWithEnds.
+ *  @param  verticesContainedByPath1    See
+ *   containsDisjointSpanningPathsWithEnds.
+ *  @param  startOfPath2    See containsDisjointSpanningPathsWithEnds.
+ *  @param  endOfPath2  See containsDisjointSpanningPathsWithEnds.
+ *  @param  verticesContainedByPath2    See
+ *   containsDisjointSpanningPathsWithEnds.
+ *  @param  allCyclesFlag   See containsDisjointSpanningPathsWithEnds.
+ *  @param  verboseFlag See containsDisjointSpanningPathsWithEnds.
+ * */
+bool containsDisjointSpanningPathsWithConstraints(bitset adjacencyList[], int
+numberOfVertices, struct searchConstraints *constraints, int startOfPath1,
+int endOfPath1, bitset verticesContainedByPath1, int startOfPath2, int
+endOfPath2, bitset verticesContainedByPath2, bool allCyclesFlag, bool
+verboseFlag);
+
 #endif
\ No newline at end of file
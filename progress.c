@@ -0,0 +1,163 @@
+/**
+ * progress.c
+ *
+ * A description of the methods can be found in the header file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "progress.h"
+#include "hamiltonicityMethods.h"
+
+//  The numbers reported by the programs, which are read by the reporter
+//  thread.
+static atomic_ullong linesRead;
+static atomic_ullong bytesRead;
+static atomic_ullong graphsChecked;
+static atomic_ullong categoryCounts[MAXPROGRESSCATEGORIES];
+
+struct reporter {
+    double interval;
+    int numberOfCategories;
+    const char *categoryNames[MAXPROGRESSCATEGORIES];
+
+    //  The size of stdin in bytes, or 0 if it is not a regular file.
+    unsigned long long int inputSize;
+
+    struct timespec start;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t stopRequested;
+    bool stopped;
+};
+
+static struct reporter *reporter = NULL;
+
+void reportInput(unsigned long long int lines, unsigned long long int bytes) {
+    atomic_store_explicit(&linesRead, lines, memory_order_relaxed);
+    atomic_store_explicit(&bytesRead, bytes, memory_order_relaxed);
+}
+
+void reportCheckedGraphs(unsigned long long int graphs, const unsigned long
+long int counts[]) {
+    atomic_store_explicit(&graphsChecked, graphs, memory_order_relaxed);
+    int numberOfCategories = reporter ? reporter->numberOfCategories : 0;
+    for(int i = 0; i < numberOfCategories; i++) {
+        atomic_store_explicit(&categoryCounts[i], counts[i],
+         memory_order_relaxed);
+    }
+}
+
+static double secondsBetween(struct timespec *from, struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+//  The numbers of the previous report, from which the rates are computed.
+struct snapshot {
+    double elapsed;
+    unsigned long long int graphs;
+    long long int nodes;
+};
+
+static void printReport(struct reporter *reporter, struct snapshot
+*previous) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    struct snapshot current = {.elapsed = secondsBetween(&reporter->start,
+     &now), .graphs = atomic_load(&graphsChecked), .nodes =
+     atomic_load(&searchStatistics.nodes)};
+    double period = current.elapsed - previous->elapsed;
+    if(period <= 0) {
+        period = 1e-9;
+    }
+
+    fprintf(stderr, "Progress: %.1f s, line %llu", current.elapsed,
+     atomic_load(&linesRead));
+    unsigned long long int bytes = atomic_load(&bytesRead);
+    if(reporter->inputSize && bytes) {
+        double fraction = (double) bytes / reporter->inputSize;
+        fprintf(stderr, " (%.1f%%, ETA %.0f s)", 100 * fraction,
+         current.elapsed * (1 - fraction) / fraction);
+    }
+    fprintf(stderr, ", %llu graphs (%.1f/s), %.3g nodes/s", current.graphs,
+     (current.graphs - previous->graphs) / period,
+     (current.nodes - previous->nodes) / period);
+    for(int i = 0; i < reporter->numberOfCategories; i++) {
+        fprintf(stderr, ", %llu %s", atomic_load(&categoryCounts[i]),
+         reporter->categoryNames[i]);
+    }
+    fprintf(stderr, ".\n");
+    *previous = current;
+}
+
+static void *runReporter(void *argument) {
+    struct reporter *reporter = argument;
+    struct snapshot previous = {0};
+    struct timespec wakeUp = reporter->start;
+    pthread_mutex_lock(&reporter->mutex);
+    while(!reporter->stopped) {
+        long long int nanoseconds = wakeUp.tv_nsec +
+         (long long int) (reporter->interval * 1e9);
+        wakeUp.tv_sec += nanoseconds / 1000000000;
+        wakeUp.tv_nsec = nanoseconds % 1000000000;
+        while(!reporter->stopped && pthread_cond_timedwait(
+         &reporter->stopRequested, &reporter->mutex, &wakeUp) == 0);
+        if(!reporter->stopped) {
+            printReport(reporter, &previous);
+        }
+    }
+    pthread_mutex_unlock(&reporter->mutex);
+    return NULL;
+}
+
+void startProgress(double interval, int numberOfCategories, const char
+*categoryNames[]) {
+    reporter = calloc(1, sizeof(struct reporter));
+    if(reporter == NULL) {
+        fprintf(stderr, "Error: Out of memory.\n");
+        exit(1);
+    }
+    reporter->interval = interval;
+    reporter->numberOfCategories = numberOfCategories;
+    for(int i = 0; i < numberOfCategories; i++) {
+        reporter->categoryNames[i] = categoryNames[i];
+    }
+    struct stat input;
+    if(fstat(fileno(stdin), &input) == 0 && S_ISREG(input.st_mode)) {
+        reporter->inputSize = input.st_size;
+    }
+
+    //  The condition variable waits on the same clock as the reports use.
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&reporter->stopRequested, &attributes);
+    pthread_condattr_destroy(&attributes);
+    pthread_mutex_init(&reporter->mutex, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &reporter->start);
+    if(pthread_create(&reporter->thread, NULL, runReporter, reporter)) {
+        fprintf(stderr, "Error: Could not create thread.\n");
+        exit(1);
+    }
+}
+
+void stopProgress(void) {
+    if(reporter == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&reporter->mutex);
+    reporter->stopped = true;
+    pthread_cond_signal(&reporter->stopRequested);
+    pthread_mutex_unlock(&reporter->mutex);
+    pthread_join(reporter->thread, NULL);
+    pthread_mutex_destroy(&reporter->mutex);
+    pthread_cond_destroy(&reporter->stopRequested);
+    free(reporter);
+    reporter = NULL;
+}
@@ -0,0 +1,55 @@
+/**
+ *  This header file contains a reporter which periodically prints the
+ *  progress of a run over a stream of graphs to stderr. The programs report
+ *  how far they got in the input and how many graphs they checked, and a
+ *  separate thread prints these numbers together with the throughput since
+ *  the previous report. If stdin is a regular file, the reports also contain
+ *  the fraction of the input which was read and an estimate of the remaining
+ *  time.
+ * */
+
+#ifndef PROGRESS
+#define PROGRESS
+
+//  The largest number of categories of graphs which can be reported.
+#define MAXPROGRESSCATEGORIES 4
+
+/**
+ *  Starts a thread which prints a report every interval seconds until
+ *  stopProgress is called.
+ *
+ *  @param  interval    The number of seconds between two reports.
+ *  @param  numberOfCategories  The number of categories of graphs which are
+ *   counted, at most MAXPROGRESSCATEGORIES.
+ *  @param  categoryNames   The names under which these are reported, e.g.
+ *   "hypohamiltonian".
+ * */
+void startProgress(double interval, int numberOfCategories, const char
+*categoryNames[]);
+
+/**
+ *  Reports how much of the input was read. Is cheap enough to be called for
+ *  every line.
+ *
+ *  @param  lines   The number of lines read so far.
+ *  @param  bytes   The number of bytes read so far.
+ * */
+void reportInput(unsigned long long int lines, unsigned long long int bytes);
+
+/**
+ *  Reports how many graphs were checked. Is cheap enough to be called for
+ *  every graph.
+ *
+ *  @param  graphs  The number of graphs checked so far.
+ *  @param  categoryCounts  For every category given to startProgress, the
+ *   number of checked graphs in that category.
+ * */
+void reportCheckedGraphs(unsigned long long int graphs, const unsigned long
+long int categoryCounts[]);
+
+/**
+ *  Stops the thread started by startProgress, if any.
+ * */
+void stopProgress(void);
+
+#endif
@@ -6,7 +6,7 @@
  */
 
 #define USAGE \
-"Usage: `./satisfiesDotProduct [-1|-2] [-apv] [-e] [-e#,#] [-P#,#] [-P#,#,#,#] [-h]`"
+"Usage: `./satisfiesDotProduct [-1|-2] [-apv] [-e] [-e#,#] [-P#,#] [-P#,#,#,#] [--progress=#] [--meet-in-the-middle=#] [-h]`"
 
 
 #define HELPTEXT \
@@ -45,6 +45,13 @@ will ignore the latter, e.g.: `-e5,6v` will ignore the `-v` flag.\n\
             extra conditions\n\
     -h, --help\n\
             print help message\n\
+        --meet-in-the-middle=#\n\
+            look for hamiltonian paths between two given vertices by joining\n\
+            the paths from both ends over half of the vertices, which are\n\
+            kept in a table of at most # MiB; if a larger table is needed\n\
+            the paths are searched for as before; sends the number of such\n\
+            queries to stderr; has no effect if -v or -P is\n\
+            present\n\
     -p, --print\n\
             send a pair of independent edges (-1) or adjacent cubic vertices\n\
             (-2) satisfying the required conditions to stdout; if -a is present\n\
@@ -54,6 +61,11 @@ will ignore the latter, e.g.: `-e5,6v` will ignore the `-v` flag.\n\
             required conditions are satisfied by the pair of independent edges\n\
             (#1,#2) and (#3,#4) or the pair of adjacent cubic vertices\n\
             (#1,#2); shows all paths necessary in proving it is so\n\
+        --progress=#\n\
+            every # seconds, send the number of read lines, checked graphs\n\
+            per second, search nodes per second and graphs per category to\n\
+            stderr; if stdin is a file, also how much of it was read and the\n\
+            estimated remaining time\n\
     -v, --verbose\n\
             verbose mode; if a graph passes the filter, show a pair satisfying\n\
             the required conditions; if used with -a show all pairs\n"
@@ -66,6 +78,10 @@ will ignore the latter, e.g.: `-e5,6v` will ignore the `-v` flag.\n\
 #include "../bitset.h"
 #include "../hamiltonicityMethods.h"
 #include "../readGraph/readGraph6.h"
+#include "../progress.h"
+
+//	Identifiers of the options which only have a long version.
+enum {PROGRESS_OPTION = 256, MEET_IN_THE_MIDDLE_OPTION};
 
 int firstThreeConditions(bitset adjacencyList[], int nVertices, int
 extraConditionsVertices[], bool extraConditionsFlag, bool verboseFlag, bool
@@ -92,6 +108,7 @@ int main(int argc, char ** argv) {
 	int independentEdges[4] = {-1,-1,-1,-1};
 	int extraConditionsVertices[2] = {-1,-1};
 	int adjacentCubicVertices[2] = {-1,-1};
+	double progressInterval = 0;
 	while (1) {
     	int option_index = 0;
     	static struct option long_options[] = 
@@ -101,9 +118,13 @@ int main(int argc, char ** argv) {
         	{"all", 						no_argument, NULL, 'a'},
         	{"extra",  						optional_argument, NULL, 'e'},
             {"help",                    	no_argument, NULL,  'h'},
+        	{"meet-in-the-middle", 		  required_argument, NULL,
+        	 MEET_IN_THE_MIDDLE_OPTION},
         	{"print", 						no_argument, NULL, 'p'},
         	{"paths", 						required_argument, NULL, 'P'},
+        	{"progress", 				  required_argument, NULL, PROGRESS_OPTION},
         	{"verbose", 					no_argument, NULL,  'v'},
+        	{NULL,      					0, 			 NULL,    0}
     	};
 
     	opt = getopt_long(argc, argv, "12ae::hpP:v", long_options, &option_index);
@@ -151,6 +172,29 @@ int main(int argc, char ** argv) {
 			case 'v':
 				verboseFlag = true;
 				break;
+			case MEET_IN_THE_MIDDLE_OPTION:
+				if(sscanf(optarg, "%d",
+				 &searchSettings.meetInTheMiddleMemory) != 1 ||
+				 searchSettings.meetInTheMiddleMemory < 1) {
+					fprintf(stderr, "Error: Invalid number of MiB: %s\n",
+					 optarg);
+					fprintf(stderr, "%s\n", USAGE);
+					fprintf(stderr,
+					 "Use ./satisfiesDotProduct --help for more detailed instructions.\n");
+					return 1;
+				}
+				break;
+			case PROGRESS_OPTION:
+				if(sscanf(optarg, "%lf", &progressInterval) != 1 ||
+				 progressInterval <= 0) {
+					fprintf(stderr, "Error: Invalid number of seconds: %s\n",
+					 optarg);
+					fprintf(stderr, "%s\n", USAGE);
+					fprintf(stderr,
+					 "Use ./satisfiesDotProduct --help for more detailed instructions.\n");
+					return 1;
+				}
+				break;
 			case '?':
                 fprintf(stderr, "%s\n", USAGE);
                 fprintf(stderr,
@@ -178,9 +222,23 @@ int main(int argc, char ** argv) {
 	unsigned long long int lastThreeConditionsCounter = 0;
     unsigned long long int skippedGraphs = 0;
 
+	if(progressInterval) {
+		const char *categoryNames[] = {firstThreeConditionsFlag ?
+		 "satisfy (i)-(iii)" : "satisfy (iv)-(vi)"};
+		startProgress(progressInterval, 1, categoryNames);
+	}
+
 	char * graphString = NULL;
 	size_t size;
-	while(getline(&graphString, &size, stdin) != -1) {
+	ssize_t length;
+	unsigned long long int lines = 0;
+	unsigned long long int bytes = 0;
+	while((length = getline(&graphString, &size, stdin)) != -1) {
+		unsigned long long int categoryCounts[] = {firstThreeConditionsFlag ?
+		 firstThreeConditionsCounter : lastThreeConditionsCounter};
+		reportCheckedGraphs(counter, categoryCounts);
+		reportInput(++lines, bytes += length);
+
 		if(verboseFlag || allFlag) {
 			fprintf(stderr, "\nLooking at %s",graphString);
 		}
@@ -272,6 +330,7 @@ int main(int argc, char ** argv) {
 			}
 		}
 	}
+	stopProgress();
 	clock_t end = clock();
 	double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
 
@@ -284,9 +343,18 @@ int main(int argc, char ** argv) {
 		fprintf(stderr, "%lld satisfy the constraints for H.\n",
 		 lastThreeConditionsCounter);
 	}
+	if(searchSettings.meetInTheMiddleMemory) {
+		fprintf(stderr,
+		 "Meet-in-the-middle: %lld path queries, %lld of which needed a larger table.\n",
+		 atomic_load(&meetInTheMiddleStatistics.queries),
+		 atomic_load(&meetInTheMiddleStatistics.fallbacks));
+	}
     if(skippedGraphs) {
         fprintf(stderr, "Warning: %lld graphs could not be read.\n", skippedGraphs);
     }
+#ifdef PRUNE_STATISTICS
+	printPruneStatistics();
+#endif
 	return 0;
 }
 
@@ -395,41 +463,26 @@ printFlag, bool allFlag) {
 bool existsHamiltonianPathNotContainingEdge(bitset adjacencyList[], int
 nVertices, bitset excludedVertices, int beginning, int end, int edgeBeginning,
 int edgeEnd, bool verboseFlag) {
-	
-	removeElement(adjacencyList[edgeEnd], edgeBeginning);
-	removeElement(adjacencyList[edgeBeginning], edgeEnd);
-	
-	bool containsHamPath = containsHamiltonianPathWithEnds(adjacencyList,
-	 nVertices,excludedVertices,beginning,end,false,verboseFlag);
-
-	add(adjacencyList[edgeEnd], edgeBeginning);
-	add(adjacencyList[edgeBeginning], edgeEnd);
-	return containsHamPath;
+
+	struct searchConstraints constraints;
+	initialiseSearchConstraints(&constraints, excludedVertices);
+	forbidEdge(&constraints, edgeBeginning, edgeEnd);
+	return containsHamiltonianPathWithConstraints(adjacencyList, nVertices,
+	 &constraints, beginning, end, false, verboseFlag);
 }
 
 bool existSpanningPathsNotContainingTwoEdges(bitset adjacencyList[], int
 nVertices, bitset excludedNodes, int a, int b, int c, int d, bool verboseFlag)
 {
 
-	removeElement(adjacencyList[a],b);
-	removeElement(adjacencyList[b],a);
-	removeElement(adjacencyList[c],d);
-	removeElement(adjacencyList[d],c);
-	bool exists = false;
-
-	if (containsDisjointSpanningPathsWithEnds(adjacencyList,nVertices, 
-	 excludedNodes,a,c,EMPTY,b,d,EMPTY,false,verboseFlag))
-		exists = true;
-	else if (containsDisjointSpanningPathsWithEnds(adjacencyList,nVertices, 
-	 excludedNodes,a,d,EMPTY,b,c,EMPTY,false,verboseFlag))
-		exists = true;
-
-	add(adjacencyList[a],b);
-	add(adjacencyList[b],a);
-	add(adjacencyList[c],d);
-	add(adjacencyList[d],c);
-
-	return exists;
+	struct searchConstraints constraints;
+	initialiseSearchConstraints(&constraints, excludedNodes);
+	forbidEdge(&constraints, a, b);
+	forbidEdge(&constraints, c, d);
+	return containsDisjointSpanningPathsWithConstraints(adjacencyList,
+	 nVertices, &constraints, a, c, EMPTY, b, d, EMPTY, false, verboseFlag) ||
+	 containsDisjointSpanningPathsWithConstraints(adjacencyList, nVertices,
+	 &constraints, a, d, EMPTY, b, c, EMPTY, false, verboseFlag);
 }
 
 bool satisfiesCondition1(bitset adjacencyList[], int nVertices, int a, int b,
@@ -478,42 +531,42 @@ int c, int d, bool verboseFlag) {
 	return true;
 }
 
-bool containsAllHamPaths(bitset adjacencyList[], int nVertices, int a, int b,
-int c, int d, bool verboseFlag) {
+bool containsAllHamPaths(bitset adjacencyList[], int nVertices, struct
+searchConstraints *constraints, int a, int b, int c, int d, bool verboseFlag) {
 
 	if(verboseFlag) {
 		fprintf(stderr, "ac-");
 	}
-	if(!containsHamiltonianPathWithEnds(adjacencyList,nVertices,EMPTY, a, c,
-	 false, verboseFlag)) {
+	if(!containsHamiltonianPathWithConstraints(adjacencyList, nVertices,
+	 constraints, a, c, false, verboseFlag)) {
 		return false;
 	}
 	if(verboseFlag) {
 		fprintf(stderr, "ad-");
 	}
-	if(!containsHamiltonianPathWithEnds(adjacencyList,nVertices,EMPTY, a, d,
-	 false, verboseFlag)) {
+	if(!containsHamiltonianPathWithConstraints(adjacencyList, nVertices,
+	 constraints, a, d, false, verboseFlag)) {
 		return false;
 	}
 	if(verboseFlag) {
 		fprintf(stderr, "bc-");
 	}
-	if(!containsHamiltonianPathWithEnds(adjacencyList,nVertices,EMPTY, b, c,
-	 false, verboseFlag)) {
+	if(!containsHamiltonianPathWithConstraints(adjacencyList, nVertices,
+	 constraints, b, c, false, verboseFlag)) {
 		return false;
 	}
 	if(verboseFlag) {
 		fprintf(stderr, "bd-");
 	}
-	if(!containsHamiltonianPathWithEnds(adjacencyList,nVertices,EMPTY, b, d,
-	 false, verboseFlag)) {
+	if(!containsHamiltonianPathWithConstraints(adjacencyList, nVertices,
+	 constraints, b, d, false, verboseFlag)) {
 		return false;
 	}
 	if(verboseFlag) {
 		fprintf(stderr, "ab- and cd-paths:\n");
 	}
-	if(!containsDisjointSpanningPathsWithEnds(adjacencyList, nVertices, EMPTY,
-	 a,b, EMPTY ,c,d, EMPTY, false, verboseFlag)) {
+	if(!containsDisjointSpanningPathsWithConstraints(adjacencyList, nVertices,
+	 constraints, a, b, EMPTY, c, d, EMPTY, false, verboseFlag)) {
 		return false;
 	}
 	return true;
@@ -526,46 +579,22 @@ int c, int d, bool verboseFlag) {
 		fprintf(stderr, "\n(ii):\n");
 	}
 
-	// Work with boolean since we need to add edges back to graph at the end.
-	bool admitsForAny = true; 
-	removeElement(adjacencyList[a],b);
-	removeElement(adjacencyList[b],a);
-	removeElement(adjacencyList[c],d);
-	removeElement(adjacencyList[d],c);
-
-	if(!containsAllHamPaths(adjacencyList, nVertices, a,b,c,d, verboseFlag))
-		admitsForAny = false;
-
-	add(adjacencyList[a],b);
-	add(adjacencyList[b],a);
-	add(adjacencyList[c],d);
-	add(adjacencyList[d],c);
-	return admitsForAny;
+	struct searchConstraints constraints;
+	initialiseSearchConstraints(&constraints, EMPTY);
+	forbidEdge(&constraints, a, b);
+	forbidEdge(&constraints, c, d);
+	return containsAllHamPaths(adjacencyList, nVertices, &constraints, a, b, c,
+	 d, verboseFlag);
 }
 
 bool containsHamCycleWithEdge(bitset adjacencyList[], int nVertices, bitset
 excludedVertices, int edgeStart, int edgeEnd, bool verboseFlag) {
 
-	bitset remainingVertices = complement(excludedVertices, nVertices);
-	removeElement(remainingVertices, edgeStart);
-	removeElement(remainingVertices, edgeEnd);
-	if(!verboseFlag) {
-		if(canBeHamiltonian(adjacencyList,remainingVertices,edgeStart,edgeEnd,
-		 nVertices - size(excludedVertices), 2)) {
-			return true;
-		}
-		return false;
-	}
-	int pathList[nVertices - size(excludedVertices)];
-	pathList[0] = edgeStart;
-	pathList[1] = edgeEnd;
-	int n = 0;
-	if(canBeHamiltonianPrintCycle(adjacencyList,remainingVertices, pathList,
-	 edgeStart,edgeEnd,nVertices - size(excludedVertices),2,&n,false,
-	 verboseFlag)) {
-		return true;
-	}
-	return false;
+	struct searchConstraints constraints;
+	initialiseSearchConstraints(&constraints, excludedVertices);
+	requireEdge(&constraints, edgeStart, edgeEnd);
+	return isHamiltonianWithConstraints(adjacencyList, nVertices, &constraints,
+	 false, verboseFlag);
 }
 
 bool satisfiesCondition3(bitset adjacencyList[], int nVertices, int a, int b,
@@ -646,20 +675,16 @@ int b, int c, int d, int xG, int yG, bool verboseFlag) {
 	if(verboseFlag) {
 		fprintf(stderr, "Disjoint spanning cycles:\n");
 	}
-	removeElement(adjacencyList[a],b);
-	removeElement(adjacencyList[b],a);
-	removeElement(adjacencyList[c],d);
-	removeElement(adjacencyList[d],c);
-	bool containsDisjPaths =
-	 containsDisjointSpanningPathsWithEnds(adjacencyList, nVertices, EMPTY, a, b,
-	 singleton(xG), c, d, singleton(yG), false, verboseFlag) ||
-	 containsDisjointSpanningPathsWithEnds(adjacencyList, nVertices, EMPTY, a, b,
-	 singleton(yG), c, d, singleton(xG), false, verboseFlag);
-	add(adjacencyList[a],b);
-	add(adjacencyList[b],a);
-	add(adjacencyList[c],d);
-	add(adjacencyList[d],c);		
-	return containsDisjPaths;
+	struct searchConstraints constraints;
+	initialiseSearchConstraints(&constraints, EMPTY);
+	forbidEdge(&constraints, a, b);
+	forbidEdge(&constraints, c, d);
+	return containsDisjointSpanningPathsWithConstraints(adjacencyList,
+	 nVertices, &constraints, a, b, singleton(xG), c, d, singleton(yG), false,
+	 verboseFlag) ||
+	 containsDisjointSpanningPathsWithConstraints(adjacencyList, nVertices,
+	 &constraints, a, b, singleton(yG), c, d, singleton(xG), false,
+	 verboseFlag);
 }
 
 bool extraCondition(bitset adjacencyList[], int nVertices, int a, int b, int c,
@@ -830,6 +855,35 @@ bool verboseFlag) {
 bool containsHamSTPath(bitset adjacencyList[], int nVertices,int x,int y,int
 v,int w, bool verboseFlag) {
 
+	//	Without paths to print, all pairs (s,t) are searched together. A
+	//	common neighbour of x and y is not a pair for findHamiltonianPathEnds
+	//	and is searched as before.
+	if(!verboseFlag) {
+		bitset excludedVertices = union(singleton(x), singleton(y));
+		add(excludedVertices, v);
+		add(excludedVertices, w);
+		bitset starts = difference(adjacencyList[x], excludedVertices);
+		bitset ends = difference(adjacencyList[y], excludedVertices);
+		bitset requestedPairs[nVertices];
+		bitset pathEnds[nVertices];
+		for(int i = 0; i < nVertices; i++) {
+			requestedPairs[i] = EMPTY;
+		}
+		forEach(s, starts) {
+			requestedPairs[s] = ends;
+		}
+		if(findHamiltonianPathEnds(adjacencyList, nVertices, excludedVertices,
+		 requestedPairs, true, pathEnds)) {
+			return true;
+		}
+		forEach(s, intersection(starts, ends)) {
+			if(containsHamiltonianPathWithEnds(adjacencyList,nVertices,
+			 excludedVertices,s,s,false,false))
+				return true;
+		}
+		return false;
+	}
+
 	forEach(s, difference(adjacencyList[x], singleton(y))) {
 		if( s == v || s == w) continue;
 		forEach(t, difference(adjacencyList[y], singleton(x))) {
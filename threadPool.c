@@ -0,0 +1,113 @@
+/**
+ * threadPool.c
+ *
+ * A description of the methods can be found in the header file.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "threadPool.h"
+
+//  A call of runTasks which still has tasks that have not been started.
+struct job {
+    void (*task)(void *, int);
+    void *argument;
+    int numberOfTasks;
+    int nextTask;
+    int unfinishedTasks;
+    int helpers;
+    int maxHelpers;
+    pthread_cond_t finished;
+    struct job *next;
+};
+
+//  The threads of the pool are created when they are first needed and wait
+//  for jobs until the program exits.
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobAvailable = PTHREAD_COND_INITIALIZER;
+static struct job *jobs = NULL;
+static int numberOfPoolThreads = 0;
+
+static void removeJob(struct job *job) {
+    for(struct job **current = &jobs; *current != NULL;
+     current = &(*current)->next) {
+        if(*current == job) {
+            *current = job->next;
+            return;
+        }
+    }
+}
+
+//  Execute tasks of job until none are left to start. Should be called with
+//  poolMutex locked and returns with poolMutex locked.
+static void workOnJob(struct job *job) {
+    while(job->nextTask < job->numberOfTasks) {
+        int task = job->nextTask++;
+        if(job->nextTask == job->numberOfTasks) {
+            removeJob(job);
+        }
+        pthread_mutex_unlock(&poolMutex);
+        job->task(job->argument, task);
+        pthread_mutex_lock(&poolMutex);
+        if(--job->unfinishedTasks == 0) {
+            pthread_cond_signal(&job->finished);
+        }
+    }
+}
+
+static void *poolThread(void *argument) {
+    pthread_mutex_lock(&poolMutex);
+    while(1) {
+        struct job *job = jobs;
+        while(job != NULL && job->helpers >= job->maxHelpers) {
+            job = job->next;
+        }
+        if(job == NULL) {
+            pthread_cond_wait(&jobAvailable, &poolMutex);
+            continue;
+        }
+        job->helpers++;
+        workOnJob(job);
+        job->helpers--;
+    }
+    return NULL;
+}
+
+void runTasks(int numberOfThreads, int numberOfTasks, void (*task)(void *,
+int), void *argument) {
+    if(numberOfThreads <= 1 || numberOfTasks <= 1) {
+        for(int i = 0; i < numberOfTasks; i++) {
+            task(argument, i);
+        }
+        return;
+    }
+
+    struct job job = {.task = task, .argument = argument, .numberOfTasks =
+     numberOfTasks, .unfinishedTasks = numberOfTasks, .maxHelpers =
+     numberOfThreads - 1};
+    pthread_cond_init(&job.finished, NULL);
+
+    pthread_mutex_lock(&poolMutex);
+    while(numberOfPoolThreads < numberOfThreads - 1) {
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, poolThread, NULL)) {
+            fprintf(stderr, "Error: Could not create thread.\n");
+            exit(1);
+        }
+        pthread_detach(thread);
+        numberOfPoolThreads++;
+    }
+    job.next = jobs;
+    jobs = &job;
+    pthread_cond_broadcast(&jobAvailable);
+
+    workOnJob(&job);
+    while(job.unfinishedTasks > 0) {
+        pthread_cond_wait(&job.finished, &poolMutex);
+    }
+    pthread_mutex_unlock(&poolMutex);
+    pthread_cond_destroy(&job.finished);
+}
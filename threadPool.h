@@ -0,0 +1,27 @@
+/**
+ *  This header file contains a minimal thread pool which is used to divide
+ *  independent tasks, such as the hamiltonicity checks of the subgraphs of a
+ *  graph, over multiple threads.
+ * */
+
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+/**
+ *  Executes task(argument, i) for every 0 <= i < numberOfTasks and returns
+ *  once all of these have finished. The tasks are divided over the calling
+ *  thread and at most numberOfThreads - 1 threads of the pool. Since the
+ *  calling thread always takes part, tasks can themselves call runTasks
+ *  without the risk of a deadlock.
+ *
+ *  @param  numberOfThreads The maximal number of threads, including the
+ *   calling thread, executing the tasks. If it is 1 or less, all tasks are
+ *   executed in order by the calling thread.
+ *  @param  numberOfTasks   The number of tasks.
+ *  @param  task    The function which is called for every task.
+ *  @param  argument    The argument which is passed to every call of task.
+ * */
+void runTasks(int numberOfThreads, int numberOfTasks, void (*task)(void *,
+int), void *argument);
+
+#endif